@@ -0,0 +1,71 @@
+// ApproxTransformer.cpp
+//
+//--------------------------------------------
+
+
+#include <functional>
+#include <cmath>
+
+#include "ApproxTransformer.hpp"
+
+namespace GeoStar {
+
+    constexpr double ApproxTransformer::DEFAULT_MAX_ERROR;
+    const long int ApproxTransformer::MIN_SEGMENT;
+
+
+
+    ApproxTransformer::ApproxTransformer(const RowFunction &exact, const double &maxError) {
+        this->exact = exact;
+        this->maxError = maxError;
+    }// end-ApproxTransformer-constructor
+
+
+
+    void ApproxTransformer::transformRow(const long int &y, const long int &x0, const long int &n,
+                                         double *xs, double *ys) const {
+        if (maxError <= 0.0 || n <= MIN_SEGMENT + 1) {
+            exact(y, x0, n, xs, ys);
+            return;
+        }
+        exact(y, x0, 1, xs, ys);
+        exact(y, x0 + n - 1, 1, xs + n - 1, ys + n - 1);
+        approximate(y, x0, 0, n - 1, xs, ys);
+    }// end: transformRow
+
+
+
+    void ApproxTransformer::approximate(const long int &y, const long int &x0, const long int &a, const long int &b,
+                                        double *xs, double *ys) const {
+        if (b - a <= 1) return;
+
+        // short runs, and runs with an end that does not map, are done exactly:
+        bool endsFinite = std::isfinite(xs[a]) && std::isfinite(ys[a]) && std::isfinite(xs[b]) && std::isfinite(ys[b]);
+        if (b - a <= MIN_SEGMENT || !endsFinite) {
+            exact(y, x0 + a + 1, b - a - 1, xs + a + 1, ys + a + 1);
+            return;
+        }
+
+        // the exact middle, against the line through the ends:
+        long int m = (a + b) / 2;
+        exact(y, x0 + m, 1, xs + m, ys + m);
+        double stepX = (xs[b] - xs[a]) / (double)(b - a);
+        double stepY = (ys[b] - ys[a]) / (double)(b - a);
+        double errorX = std::fabs(xs[a] + stepX * (m - a) - xs[m]);
+        double errorY = std::fabs(ys[a] + stepY * (m - a) - ys[m]);
+
+        if (errorX <= maxError && errorY <= maxError) {
+            for (long int k = a + 1; k < b; k++) {
+                if (k == m) continue;
+                xs[k] = xs[a] + stepX * (k - a);
+                ys[k] = ys[a] + stepY * (k - a);
+            }// endfor: k
+            return;
+        }
+
+        // (a non-finite middle fails the test too, and is split around)
+        approximate(y, x0, a, m, xs, ys);
+        approximate(y, x0, m, b, xs, ys);
+    }// end: approximate
+
+}// end namespace GeoStar
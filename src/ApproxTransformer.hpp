@@ -0,0 +1,82 @@
+// ApproxTransformer.hpp
+//
+//----------------------------------------
+#ifndef APPROXTRANSFORMER_HPP_
+#define APPROXTRANSFORMER_HPP_
+
+
+#include <functional>
+
+
+namespace GeoStar {
+
+/** \brief ApproxTransformer -- a row transform that calls an expensive exact transform only where it must.
+
+Along a row of output pixels, a coordinate transformation (a map projection, say) is nearly always
+very close to a straight line over a few hundred pixels.  ApproxTransformer evaluates the exact
+transform at the two ends of a row and at its middle; if the straight line through the ends is
+within maxError (in the units of the result, input pixels for Raster::transform) of the exact middle,
+the pixels in between are interpolated along that line.  Otherwise the row is split at the middle,
+and each half is treated the same way, down to runs of a few pixels, which are transformed exactly.
+
+\see Raster::transform
+
+\par Usage Overview
+\code
+   GeoStar::ApproxTransformer approx(exactRow, 0.05);
+   approx.transformRow(y, x0, n, xs, ys);     // same results as exactRow, to within about 0.05
+\endcode
+
+\par Details
+The error is only measured at the middle of each run.  Where the transform is close to quadratic
+along the run (the usual case over a few hundred pixels), that is where the line is farthest from
+it; higher-order terms can put the largest error elsewhere, and somewhat above maxError, so
+maxError is best set below the error that can be tolerated.
+
+A maxError of 0 (or less) turns the approximation off: transformRow calls the exact transform
+for the whole row.  A point the exact transform can not map (a result that is not finite) stops
+the approximation of the part of the row around it, which is then transformed exactly.
+
+transformRow does not change the ApproxTransformer, so any number of threads may call it at once,
+as long as the exact transform allows that.
+*/
+  class ApproxTransformer {
+
+  public:
+      // the exact transform: the results (xs[k], ys[k]) for the n pixels (x0 + k, y) of a row
+      typedef std::function<void(const long int &y, const long int &x0, const long int &n,
+                                 double *xs, double *ys)> RowFunction;
+
+      // the default largest error at a midpoint: half of the 0.1 pixel that reprojection aims for,
+      //  since the error between the points tested can be somewhat larger (see Details)
+      static constexpr double DEFAULT_MAX_ERROR = 0.05;
+
+      // runs of this many pixels or fewer are transformed exactly, not split further
+      static const long int MIN_SEGMENT = 4;
+
+  private:
+      RowFunction exact;
+      double maxError;
+
+      // fills the pixels strictly between a and b of the row; xs/ys at a and b are already exact
+      void approximate(const long int &y, const long int &x0, const long int &a, const long int &b,
+                       double *xs, double *ys) const;
+
+  public:
+      ApproxTransformer(const RowFunction &exact, const double &maxError = DEFAULT_MAX_ERROR);
+
+      // the (approximate) results for the n pixels (x0 + k, y) of a row, as for the exact transform
+      void transformRow(const long int &y, const long int &x0, const long int &n,
+                        double *xs, double *ys) const;
+
+      // return the largest error
+      inline double getMaxError() const {
+          return maxError;
+      }
+
+  }; // end class: ApproxTransformer
+
+}// end namespace GeoStar
+
+
+#endif //APPROXTRANSFORMER_HPP_
@@ -0,0 +1,90 @@
+// ChunkCache.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+#include "H5Cpp.h"
+
+#include "ChunkCache.hpp"
+
+namespace GeoStar {
+
+    const size_t ChunkCache::DEFAULT_NBYTES;
+    const size_t ChunkCache::DEFAULT_NSLOTS;
+    const size_t ChunkCache::MAX_NBYTES;
+    const size_t ChunkCache::TYPICAL_CHUNK_NBYTES;
+
+
+    ChunkCache::ChunkCache() {
+        this->nbytes = DEFAULT_NBYTES;
+        this->nslots = DEFAULT_NSLOTS;
+        this->w0 = 0.75;
+    }
+
+
+    ChunkCache::ChunkCache(const size_t &nbytes, const size_t &nslots, const double &w0) {
+        this->nbytes = nbytes;
+        this->nslots = nslots;
+        setW0(w0);
+    }// end-ChunkCache-constructor
+
+
+    ChunkCache ChunkCache::forChunks(const size_t &nChunks, const size_t &chunkBytes, const double &w0) {
+        size_t bytes = nChunks * chunkBytes;
+        if (chunkBytes > 0 && bytes / chunkBytes != nChunks) bytes = MAX_NBYTES;   // overflow
+        bytes = std::max(DEFAULT_NBYTES, std::min(MAX_NBYTES, bytes));
+        return ChunkCache(bytes, 0, w0);
+    }// end: forChunks
+
+
+    void ChunkCache::setW0(const double &w0) {
+        this->w0 = std::max(0.0, std::min(1.0, w0));
+    }
+
+
+    size_t ChunkCache::nextPrime(size_t n) {
+        if (n <= 2) return 2;
+        if (n % 2 == 0) n++;
+        for (;; n += 2) {
+            bool prime = true;
+            for (size_t d = 3; d*d <= n; d += 2) {
+                if (n % d == 0) {
+                    prime = false;
+                    break;
+                }
+            }// endfor
+            if (prime) return n;
+        }// endfor
+    }// end: nextPrime
+
+
+    size_t ChunkCache::slotsFor(const size_t &chunkBytes) const {
+        if (nslots > 0) return nslots;
+
+        // the HDF5 guide: ~100 times the number of chunks that fit in the cache, and prime.
+        //  (capped: each slot costs a pointer, and tiny chunks would ask for millions of them)
+        size_t nChunks = nbytes / std::max((size_t)1, chunkBytes);
+        size_t slots = std::min((size_t)1000000, 100*std::max((size_t)1, nChunks));
+        return nextPrime(std::max(DEFAULT_NSLOTS, slots));
+    }// end: slotsFor
+
+
+    H5::FileAccPropList ChunkCache::fileAccPropList() const {
+        H5::FileAccPropList fapl;
+        // the metadata cache element count is ignored by HDF5 1.8 and later
+        fapl.setCache(0, slotsFor(TYPICAL_CHUNK_NBYTES), nbytes, w0);
+        return fapl;
+    }// end: fileAccPropList
+
+
+    H5::DSetAccPropList ChunkCache::dsetAccPropList(const size_t &chunkBytes) const {
+        H5::DSetAccPropList dapl;
+        dapl.setChunkCache(slotsFor(chunkBytes), nbytes, w0);
+        return dapl;
+    }// end: dsetAccPropList
+
+}// end namespace GeoStar
@@ -0,0 +1,127 @@
+// ChunkCache.hpp
+//
+//----------------------------------------
+#ifndef CHUNKCACHE_HPP_
+#define CHUNKCACHE_HPP_
+
+
+#include <string>
+#include <cstddef>
+
+#include "H5Cpp.h"
+
+
+namespace GeoStar {
+
+/** \brief ChunkCache -- the HDF5 raw-data chunk cache settings of a GeoStar file or raster.
+
+HDF5 keeps recently used chunks of a chunked dataset in memory, decompressed, in a per-dataset
+"chunk cache".  A chunk that does not stay in the cache between two accesses is read from disk
+and decompressed again (or, for writes, compressed and written again), so the cache should be
+big enough to hold all of the chunks that an operation revisits.
+
+\see File, Raster, RasterLayout
+
+\par Usage Overview
+A ChunkCache can be given to the File constructor, where it becomes the default for every raster
+opened in that file, or to Raster::setChunkCache, which changes the cache of one raster.
+
+The default-constructed ChunkCache has the HDF5 library defaults: 1 MiB, 521 hash slots, and a
+preemption policy of 0.75.
+
+\par Details
+The cache has 3 settings:
+- nbytes: the total size of the cache, in bytes.
+- nslots: the number of slots in the cache's hash table.  It should be a prime number about 100
+  times the number of chunks that fit in the cache.  0 means "pick one automatically", which
+  is done from the chunk size when the cache is applied.
+- w0: the preemption policy, from 0 to 1.  When the cache is full, chunks that have been fully
+  read or written are evicted first if w0 is 1; w0 = 0 treats them like any other chunk.
+  Use 1 when each chunk is used once (row scans), and 0 when partly used chunks will be
+  revisited (column scans).
+
+The built-in Raster operations size their own cache for their access pattern, and restore the
+raster's cache when they are done.  Caches are never made bigger than MAX_NBYTES.
+*/
+  class ChunkCache {
+
+  private:
+      size_t nbytes;      // total cache size, in bytes
+      size_t nslots;      // hash table slots; 0 means automatic
+      double w0;          // preemption policy, 0..1
+
+      // the smallest prime >= n
+      static size_t nextPrime(size_t n);
+
+  public:
+      // the HDF5 library defaults
+      static const size_t DEFAULT_NBYTES = 1048576;
+      static const size_t DEFAULT_NSLOTS = 521;
+
+      // upper limit for the caches the built-in operations ask for
+      static const size_t MAX_NBYTES = 268435456;
+
+      // chunk size assumed for automatic slot counts at the file level, where no dataset is known
+      static const size_t TYPICAL_CHUNK_NBYTES = 262144;
+
+      // default cache: the HDF5 defaults
+      ChunkCache();
+
+      ChunkCache(const size_t &nbytes, const size_t &nslots = 0, const double &w0 = 0.75);
+
+      // a cache holding nChunks chunks of chunkBytes each (at least the default size, and at
+      //  most MAX_NBYTES), with preemption policy w0.
+      static ChunkCache forChunks(const size_t &nChunks, const size_t &chunkBytes, const double &w0);
+
+      // return cache size, in bytes
+      inline size_t getNbytes() const {
+          return nbytes;
+      }
+
+      // return number of hash slots (0: automatic)
+      inline size_t getNslots() const {
+          return nslots;
+      }
+
+      // return preemption policy
+      inline double getW0() const {
+          return w0;
+      }
+
+      // set the cache size, in bytes
+      inline void setNbytes(const size_t &nbytes) {
+          this->nbytes = nbytes;
+      }
+
+      // set the number of hash slots (0: automatic)
+      inline void setNslots(const size_t &nslots) {
+          this->nslots = nslots;
+      }
+
+      // set the preemption policy (clamped to 0..1)
+      void setW0(const double &w0);
+
+      // the number of hash slots to use for chunks of chunkBytes each:
+      //  nslots if it was given, otherwise a prime about 100 times the number of chunks that fit.
+      size_t slotsFor(const size_t &chunkBytes) const;
+
+      // the HDF5 file access property list, for File
+      H5::FileAccPropList fileAccPropList() const;
+
+      // the HDF5 dataset access property list, for a Raster with chunks of chunkBytes each
+      H5::DSetAccPropList dsetAccPropList(const size_t &chunkBytes) const;
+
+      inline bool operator==(const ChunkCache &other) const {
+          return nbytes == other.nbytes && nslots == other.nslots && w0 == other.w0;
+      }
+
+      inline bool operator!=(const ChunkCache &other) const {
+          return !(*this == other);
+      }
+
+  }; // end class: ChunkCache
+
+}// end namespace GeoStar
+
+
+#endif //CHUNKCACHE_HPP_
@@ -0,0 +1,129 @@
+// CoordinateTransformCache.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <limits>
+
+#include <ogr_spatialref.h>
+
+#include "CoordinateTransformCache.hpp"
+#include "Exceptions.hpp"
+
+namespace GeoStar {
+
+    // parse a WKT string into srs (importFromWkt moves the pointer it is given, so it gets a copy)
+    static void importWKT(OGRSpatialReference &srs, const std::string &wkt) {
+        std::vector<char> chars(wkt.begin(), wkt.end());
+        chars.push_back('\0');
+        char *next = &chars[0];
+        if (srs.importFromWkt(&next) != OGRERR_NONE)
+            throw_CoordinateTransformError("can not parse WKT: " + wkt);
+    }
+
+
+
+    CoordinateTransformCache::Entry &CoordinateTransformCache::entry(const std::string &sourceWKT,
+                                                                     const std::string &targetWKT) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::pair<std::string, std::string> key(sourceWKT, targetWKT);
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<Entry> >::iterator found = entries.find(key);
+        if (found != entries.end()) return *found->second;
+
+        // (made under the lock, so two threads asking for a new pair make it only once)
+        std::unique_ptr<Entry> made(new Entry);
+        importWKT(made->source, sourceWKT);
+        importWKT(made->target, targetWKT);
+        made->transform.reset(OGRCreateCoordinateTransformation(&made->source, &made->target));
+        if (!made->transform) throw_CoordinateTransformError("no transformation\nsource WKT: " + sourceWKT +
+                                                             "\ndestination WKT: " + targetWKT);
+        Entry &added = *made;
+        entries[key] = std::move(made);
+        return added;
+    }// end: entry
+
+
+
+    long int CoordinateTransformCache::transform(const std::string &sourceWKT, const std::string &targetWKT,
+                                                 const long int &n, double *x, double *y) {
+        Entry &pair = entry(sourceWKT, targetWKT);
+        std::lock_guard<std::mutex> lock(pair.mutex);
+        return transformPoints(pair.transform.get(), n, x, y);
+    }// end: transform
+
+
+
+    long int CoordinateTransformCache::transformPooled(const std::string &sourceWKT, const std::string &targetWKT,
+                                                       const long int &n, double *x, double *y) {
+        Entry &pair = entry(sourceWKT, targetWKT);
+        TransformPtr mine;
+        {
+            std::lock_guard<std::mutex> lock(pair.poolMutex);
+            if (!pair.pool.empty()) {
+                mine = std::move(pair.pool.back());
+                pair.pool.pop_back();
+            }
+        }
+        if (!mine) mine = clone(sourceWKT, targetWKT);
+
+        // (only this call uses mine, so no lock is held while it works)
+        long int failed = transformPoints(mine.get(), n, x, y);
+
+        std::lock_guard<std::mutex> lock(pair.poolMutex);
+        pair.pool.push_back(std::move(mine));
+        return failed;
+    }// end: transformPooled
+
+
+
+    CoordinateTransformCache::TransformPtr CoordinateTransformCache::clone(const std::string &sourceWKT,
+                                                                           const std::string &targetWKT) {
+        Entry &pair = entry(sourceWKT, targetWKT);
+        std::lock_guard<std::mutex> lock(pair.mutex);
+        TransformPtr copy(OGRCreateCoordinateTransformation(&pair.source, &pair.target));
+        if (!copy) throw_CoordinateTransformError("no transformation\nsource WKT: " + sourceWKT +
+                                                  "\ndestination WKT: " + targetWKT);
+        return copy;
+    }// end: clone
+
+
+
+    long int CoordinateTransformCache::transformPoints(OGRCoordinateTransformation *transform, const long int &n,
+                                                       double *x, double *y) {
+        if (n <= 0) return 0;
+        std::vector<int> success(n, 0);
+        // the return value only says whether all (or, in newer GDALs, any) points worked:
+        //  success has the answer for each point
+        transform->Transform((int)n, x, y, NULL, &success[0]);
+
+        long int failed = 0;
+        for (long int k = 0; k < n; k++) {
+            if (!success[k]) {
+                x[k] = std::numeric_limits<double>::quiet_NaN();
+                y[k] = std::numeric_limits<double>::quiet_NaN();
+                failed++;
+            }
+        }// endfor: k
+        return failed;
+    }// end: transformPoints
+
+
+
+    void CoordinateTransformCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }// end: clear
+
+
+
+    size_t CoordinateTransformCache::size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }// end: size
+
+}// end namespace GeoStar
@@ -0,0 +1,120 @@
+// CoordinateTransformCache.hpp
+//
+//----------------------------------------
+#ifndef COORDINATETRANSFORMCACHE_HPP_
+#define COORDINATETRANSFORMCACHE_HPP_
+
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <utility>
+
+#include <ogr_spatialref.h>
+
+
+namespace GeoStar {
+
+/** \brief CoordinateTransformCache -- the OGR coordinate transformations used by a File.
+
+Making an OGRCoordinateTransformation means parsing two WKT strings and setting up PROJ, which
+costs far more than transforming a row of points.  A CoordinateTransformCache makes the
+transformation for each (source WKT, target WKT) pair once, the first time it is asked for, and
+keeps it until the cache is cleared or goes away.  Each File has one (File::getTransformCache), so
+reprojecting every channel of every image in a file sets up each transformation once.
+
+\see Raster::transform, File
+
+\par Usage Overview
+\code
+   GeoStar::CoordinateTransformCache &cache = file->getTransformCache();
+   cache.transform(srcWKT, targetWKT, n, x, y);       // a whole row at a time
+
+   // from worker threads: each call borrows a transformation of its own from the cache's pool
+   cache.transformPooled(srcWKT, targetWKT, n, x, y);
+
+   // or a transformation for the caller alone:
+   GeoStar::CoordinateTransformCache::TransformPtr mine = cache.clone(srcWKT, targetWKT);
+   GeoStar::CoordinateTransformCache::transformPoints(mine.get(), n, x, y);
+\endcode
+
+\par Details
+An OGRCoordinateTransformation may not be used by two threads at once, so transform uses the
+cached transformation of a pair from one thread at a time.  Threads that transform many points
+use transformPooled instead: each call borrows a transformation of the pair that no other call is
+using, from a pool kept with the pair, and gives it back when done.  A new one (made from the
+cached, already parsed, spatial references) is added only when all of the pool is in use, so the
+pool holds no more transformations than were ever in use at once, and they serve every later
+call (later rows, rasters and thread pools).  clone makes one for the caller to keep.
+
+Points that can not be transformed (outside the area of a projection, say) are set to NaN by
+transform and transformPoints, which return how many there were.  A WKT string that can not be
+parsed, or a pair with no transformation between them, throws CoordinateTransformError.
+*/
+  class CoordinateTransformCache {
+
+  public:
+      // OGR objects are freed by OGR
+      struct DestroyTransform {
+          inline void operator()(OGRCoordinateTransformation *transform) const {
+              OGRCoordinateTransformation::DestroyCT(transform);
+          }
+      };
+      typedef std::unique_ptr<OGRCoordinateTransformation, DestroyTransform> TransformPtr;
+
+  private:
+      // one (source, target) pair: the parsed spatial references, and the shared transformation
+      struct Entry {
+          OGRSpatialReference source;
+          OGRSpatialReference target;
+          TransformPtr transform;
+          std::mutex mutex;           // held while transform (or source/target) is in use
+          std::vector<TransformPtr> pool;   // transformations not in use, see transformPooled
+          std::mutex poolMutex;       // guards pool
+      };
+
+      std::mutex mutex;               // guards entries (not what is in them)
+      std::map<std::pair<std::string, std::string>, std::unique_ptr<Entry> > entries;
+
+      CoordinateTransformCache(const CoordinateTransformCache &) = delete;
+      CoordinateTransformCache &operator=(const CoordinateTransformCache &) = delete;
+
+      // the entry for the pair, made if needed
+      Entry &entry(const std::string &sourceWKT, const std::string &targetWKT);
+
+  public:
+      CoordinateTransformCache() {}
+
+      // transform the n points (x[k], y[k]) in place, from sourceWKT to targetWKT, with the
+      //  cached transformation.  Returns the number of points that could not be transformed
+      //  (set to NaN).
+      long int transform(const std::string &sourceWKT, const std::string &targetWKT,
+                         const long int &n, double *x, double *y);
+
+      // as transform, but with a transformation from the pair's pool that no other call is using
+      //  (made if all are in use), so threads do not wait for each other
+      long int transformPooled(const std::string &sourceWKT, const std::string &targetWKT,
+                                 const long int &n, double *x, double *y);
+
+      // a new transformation from sourceWKT to targetWKT, for the caller alone
+      TransformPtr clone(const std::string &sourceWKT, const std::string &targetWKT);
+
+      // transform the n points (x[k], y[k]) in place with the given transformation, in one call.
+      //  Returns the number of points that could not be transformed (set to NaN).
+      static long int transformPoints(OGRCoordinateTransformation *transform, const long int &n,
+                                      double *x, double *y);
+
+      // forget all the transformations (not while another thread is using the cache; clones stay valid)
+      void clear();
+
+      // return the number of cached transformations
+      size_t size();
+
+  }; // end class: CoordinateTransformCache
+
+}// end namespace GeoStar
+
+
+#endif //COORDINATETRANSFORMCACHE_HPP_
@@ -504,6 +504,18 @@ namespace GeoStar {
 
     #define throw_FlipOptionError(arg) throw FlipOptionException(arg,__FILE__, __LINE__);
     
+    class OverviewOptionException: public geoException {
+    public:
+        OverviewOptionException(const std::string &arg, const char *file, int line) :
+        geoException(arg, file, line) {
+            std::ostringstream o;
+            o << "Invalid Overview Option: " << arg << "\n";
+            msg += o.str();
+        }
+    };
+
+    #define throw_OverviewOptionError(arg) throw OverviewOptionException(arg,__FILE__, __LINE__);
+    
 
     //struct AttributeExists{};
     //struct AttributeDoesNotExist{};
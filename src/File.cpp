@@ -6,6 +6,7 @@
 
 #include <string>
 #include <iostream>
+#include <atomic>
 
 #include "H5Cpp.h"
 //#include "H5File.h"
@@ -18,17 +19,25 @@
 
 #include "Exceptions.hpp"
 #include "attributes.hpp"
+#include "SharedTileCache.hpp"
 
 #include "boost/filesystem.hpp"
 
 namespace GeoStar {
 
+  // in-memory scratch files: the budget, the bytes in use, and a counter for unique names
+  static std::atomic<size_t> scratchBudget(536870912);
+  static std::atomic<size_t> scratchInUse(0);
+  static std::atomic<unsigned long> scratchCount(0);
+
+
   // create a new hdf5 file, or open an exising one.
   // name is the pathname of the file.
   // access can be:
   //          "new", create a new file, existence is an error
   //      or "existing", opens an existing file, non-existence is an error.
-  File::File(const std::string &name, const std::string &access) {
+  // cache is the default HDF5 chunk cache for every raster opened in this file.
+  File::File(const std::string &name, const std::string &access, const ChunkCache &cache) {
     //FileAccessException FileAccessError;
     //FileExistsException FileExistsError;
     //FileDoesNotExistException FileDoesNotExistError;
@@ -39,7 +48,7 @@ namespace GeoStar {
       if(boost::filesystem::exists( p )){
         throw_FileExistsError(name);
       }//endif
-        fileobj = new H5::H5File( name, H5F_ACC_EXCL );
+        fileobj = new H5::H5File( name, H5F_ACC_EXCL, H5::FileCreatPropList::DEFAULT, cache.fileAccPropList() );
         //fileobj = new H5::H5File( name, H5F_ACC_EXCL    , H5::FileCreatPropList::DEFAULT,  H5::FileAccPropList::DEFAULT);
         //H5::H5File fileobj( name, H5F_ACC_EXCL );
 
@@ -49,7 +58,7 @@ namespace GeoStar {
       if(!boost::filesystem::exists( p )){
         throw_FileDoesNotExistError(name);
       }//endif
-        fileobj = new H5::H5File( name, H5F_ACC_RDWR );
+        fileobj = new H5::H5File( name, H5F_ACC_RDWR, H5::FileCreatPropList::DEFAULT, cache.fileAccPropList() );
         //fileobj = new H5::H5File( name, H5F_ACC_RDWR    , H5::FileCreatPropList::DEFAULT,  H5::FileAccPropList::DEFAULT);
         //H5::H5File fileobj( name, H5F_ACC_RDWR );
 
@@ -59,6 +68,7 @@ namespace GeoStar {
 
     filename = name;
     filetype="geostar::hdf5";
+    scratchBytes = 0;
 
     // set objtype attribute.
     write_object_type(filetype);
@@ -67,6 +77,87 @@ namespace GeoStar {
 
 
 
+  File::File(H5::H5File *fileobj, const std::string &name, const std::string &scratchPath,
+             const size_t &scratchBytes) {
+    this->fileobj = fileobj;
+    this->filename = name;
+    this->filetype = "geostar::scratch";
+    this->scratchPath = scratchPath;
+    this->scratchBytes = scratchBytes;
+  }// end-File-constructor
+
+
+
+  File::~File() {
+    // cached tiles are named after the file (see Image), and would be found by a file made again
+    //  under the same name:
+    try {
+      SharedTileCache::instance().invalidatePrefix(fileobj->getFileName() + "/");
+    } catch (...) {
+    }
+    delete fileobj;
+    if (!scratchPath.empty()) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(scratchPath, ec);
+    }
+    scratchInUse -= scratchBytes;
+  }// end-File-destructor
+
+
+
+  File *File::create_scratch(const size_t &nbytes) {
+    std::string name = "geostar_scratch_" + std::to_string(++scratchCount);
+
+    // reserve the memory first, so concurrent callers cannot both squeeze under the budget:
+    if (scratchInUse.fetch_add(nbytes) + nbytes <= scratchBudget) {
+      try {
+        // core driver, no backing store: the file never touches the disk.
+        //  The increment covers the data plus some room for the HDF5 metadata.
+        H5::FileAccPropList fapl;
+        fapl.setCore(nbytes + 1048576, false);
+        H5::H5File *fileobj = new H5::H5File(name, H5F_ACC_TRUNC, H5::FileCreatPropList::DEFAULT, fapl);
+        return new File(fileobj, name, "", nbytes);
+      } catch (const H5::Exception &e) {
+        scratchInUse -= nbytes;
+        throw_FileAccessError(name + "  " + e.getDetailMsg());
+      }
+    }// endif
+    scratchInUse -= nbytes;
+
+    // too big: spill to a temporary file on disk.
+    boost::filesystem::path p = boost::filesystem::temp_directory_path()
+                              / boost::filesystem::unique_path("geostar-scratch-%%%%-%%%%-%%%%.h5");
+    try {
+      H5::H5File *fileobj = new H5::H5File(p.string(), H5F_ACC_EXCL);
+      return new File(fileobj, p.string(), p.string(), 0);
+    } catch (const H5::Exception &e) {
+      throw_FileAccessError(p.string() + "  " + e.getDetailMsg());
+    }
+  }// end: create_scratch
+
+
+
+  void File::set_scratch_budget(const size_t &nbytes) {
+    scratchBudget = nbytes;
+  }
+
+
+  size_t File::get_scratch_budget() {
+    return scratchBudget;
+  }
+
+
+
+  ChunkCache File::getChunkCache() const {
+    int mdc_nelmts;
+    size_t rdcc_nslots, rdcc_nbytes;
+    double rdcc_w0;
+    fileobj->getAccessPlist().getCache(mdc_nelmts, rdcc_nslots, rdcc_nbytes, rdcc_w0);
+    return ChunkCache(rdcc_nbytes, rdcc_nslots, rdcc_w0);
+  }// end: getChunkCache
+
+
+
   bool File::groupExists(const std::string &name) {
     try{
       H5::Exception::dontPrint();
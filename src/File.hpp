@@ -13,6 +13,8 @@
 //#include "H5File.h"
 //#include "h5cpputil.h"
 
+#include "ChunkCache.hpp"
+#include "CoordinateTransformCache.hpp"
 #include "Image.hpp"
 #include "Vector.hpp"
 #include "Ifile.hpp"
@@ -67,6 +69,11 @@ The function create_vector and open_vector merely call the appropriate construct
 
 There are 3 functions to deal with HDF5 groups in the file: checking on existence, creating, and opening.
 
+File::create_scratch makes a private, temporary HDF5 file for intermediate results (see
+Image::create_scratch_raster).  It lives in memory (HDF5 "core" driver) while the total size of
+all in-memory scratch files stays within the scratch budget (set_scratch_budget), and spills to
+a file in the system temporary directory otherwise.  Either way it is gone when deleted.
+
 */
   class File {
     
@@ -74,6 +81,18 @@ There are 3 functions to deal with HDF5 groups in the file: checking on existenc
     std::string filename;
     std::string filetype;
 
+    // scratch files only: the temporary file to remove (empty if in memory), and the
+    //  number of bytes reserved from the scratch budget (0 if on disk).
+    std::string scratchPath;
+    size_t scratchBytes;
+
+    // the coordinate transformations made for the rasters of this file (see Raster::transform)
+    CoordinateTransformCache transformCache;
+
+    // wrap an HDF5 file made by create_scratch
+    File(H5::H5File *fileobj, const std::string &name, const std::string &scratchPath,
+         const size_t &scratchBytes);
+
   public:
     H5::H5File *fileobj;
 
@@ -93,6 +112,10 @@ There are 3 functions to deal with HDF5 groups in the file: checking on existenc
             "new": create a new file, existence is an error
             "existing": open an existing file, non-existence is an error
 
+   \param[in] cache
+       Optional HDF5 chunk cache settings, used by default for every raster opened in this file.
+       Defaults to the HDF5 library defaults (1 MiB per raster).
+
    \returns
        A valid File object on success.
 
@@ -126,12 +149,20 @@ There are 3 functions to deal with HDF5 groups in the file: checking on existenc
        with value "geostar::hdf5".
        For existing files, this attribute must exist and have this value, or it is not
        a GeoStar file, and an exception is thrown.
+
+       A bigger chunk cache helps programs that read the same chunks of a compressed raster
+       many times, e.g.: new GeoStar::File("sirc_raco","existing",GeoStar::ChunkCache(64*1048576));
+       The cache of a single raster can be changed with Raster::setChunkCache.
   
   */
     // access can be either:
     //        "new": create a new file, existence is an error
     //        "existing": open an existing file, non-existence is an error
-    File(const std::string &name, const std::string &access);
+    File(const std::string &name, const std::string &access, const ChunkCache &cache = ChunkCache());
+
+
+    // return the default chunk cache of the rasters in this file
+    ChunkCache getChunkCache() const;
 
 
   /** \brief File::write_object_type allows one to change the value of the attribute string
@@ -276,9 +307,26 @@ There are 3 functions to deal with HDF5 groups in the file: checking on existenc
        using the File object destructor.
 
   */
-    // cleans up the H5::H5File object
-    inline ~File() {
-      delete fileobj;
+    // cleans up the H5::H5File object; scratch files are also removed
+    ~File();
+
+
+    // create a temporary file for about nbytes of scratch data: in memory if that fits in
+    //  the scratch budget, otherwise on disk in the system temporary directory.
+    static File *create_scratch(const size_t &nbytes);
+
+    // total bytes of in-memory scratch files allowed at one time (default 512 MiB)
+    static void set_scratch_budget(const size_t &nbytes);
+    static size_t get_scratch_budget();
+
+    // is this a scratch file kept in memory?
+    inline bool isInMemory() const {
+      return filetype == "geostar::scratch" && scratchPath.empty();
+    }
+
+    // the cache of coordinate transformations (by source and target WKT) for this file
+    inline CoordinateTransformCache &getTransformCache() {
+      return transformCache;
     }
 
 
@@ -9,6 +9,7 @@
 
 #include <string>
 #include <iostream>
+#include <algorithm>
 #include "H5Cpp.h"
 
 #include "File.hpp"
@@ -64,6 +65,153 @@ namespace GeoStar {
 
 
 
+    Raster *Image::create_scratch_raster(const std::string &name, const RasterType &type,
+                                         const int &nx, const int &ny) {
+        size_t pixelBytes = visitRasterType(type, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return sizeof(T);
+        }, name);
+
+        File *scratchFile = File::create_scratch((size_t)nx * (size_t)ny * pixelBytes);
+        Image *scratchImage = NULL;
+        Raster *ras = NULL;
+        try {
+            scratchImage = new Image(scratchFile, "scratch");
+            // throw-away data: chunk (on disk, for column scans) but never compress
+            RasterLayout layout = scratchFile->isInMemory() ? RasterLayout::contiguous()
+                                                            : RasterLayout(256, 256, false, 0);
+            ras = new Raster(scratchImage, name, type, nx, ny, layout);
+        } catch (...) {
+            delete scratchImage;
+            delete scratchFile;
+            throw;
+        }
+        ras->scratchImage = scratchImage;
+        ras->scratchFile = scratchFile;
+        return ras;
+    }// end: create_scratch_raster
+
+
+
+    Raster *Image::bandRaster(const std::string &name) {
+        std::map<std::string, Raster*>::iterator it = bandRasters.find(name);
+        if (it != bandRasters.end()) return it->second;
+        Raster *ras = open_raster(name);
+        bandRasters[name] = ras;
+        return ras;
+    }// end: bandRaster
+
+
+
+    template <typename T>
+    void Image::readBands(const Slice &slice, const std::vector<std::string> &channels, const short layout,
+                          std::vector<T> &buffer) {
+        if (layout != Image::LAYOUT_BSQ && layout != Image::LAYOUT_BIP)
+            throw_RasterReadError(fullImagename + " readBands: invalid layout " + std::to_string(layout));
+
+        long int n = slice.getCountX() * slice.getCountY();
+        long int nb = channels.size();
+        buffer.resize(n * nb);
+        if (n == 0) return;
+
+        // each band goes straight to its place in the buffer: a block of n pixels for BSQ,
+        //  every nb'th element (starting at b) for BIP.
+        for (long int b = 0; b < nb; b++) {
+            Raster *ras = bandRaster(channels[b]);
+            if (layout == Image::LAYOUT_BSQ) ras->read(slice, &buffer[b*n]);
+            else                             ras->read(slice, &buffer[b], nb);
+        }// endfor
+    }// end: readBands
+
+
+
+    void Image::create_band_stack(const std::string &name, const RasterType &type, const int &nx, const int &ny,
+                                  const int &nbands, const short interleave, const RasterLayout &layout) {
+        if (interleave != Image::LAYOUT_BSQ && interleave != Image::LAYOUT_BIP)
+            throw_RasterCreationImmutableError(fullImagename + "/" + name + " invalid interleave " + std::to_string(interleave));
+        Raster::createBandStack(this, name, type, nx, ny, nbands, interleave == Image::LAYOUT_BIP, layout);
+    }// end: create_band_stack
+
+
+
+    int Image::get_band_count(const std::string &name) {
+        Raster band0(this, name, 0);
+        hsize_t dims[3];
+        band0.rasterobj->getSpace().getSimpleExtentDims(dims);
+        return band0.bandLast ? dims[2] : dims[0];
+    }// end: get_band_count
+
+
+
+    template <typename T>
+    void Image::readBandStack(const std::string &name, const Slice &slice, const short layout, std::vector<T> &buffer) {
+        if (layout != Image::LAYOUT_BSQ && layout != Image::LAYOUT_BIP)
+            throw_RasterReadError(fullImagename + " readBandStack: invalid layout " + std::to_string(layout));
+
+        // band 0 checks the stack and gives its interleave; kept open like readBands' channels:
+        std::string key = name + "/band0";
+        Raster *ras;
+        std::map<std::string, Raster*>::iterator it = bandRasters.find(key);
+        if (it != bandRasters.end()) {
+            ras = it->second;
+        } else {
+            ras = open_band(name, 0);
+            bandRasters[key] = ras;
+        }
+
+        hsize_t dims[3];
+        H5::DataSpace dataspace = ras->rasterobj->getSpace();
+        dataspace.getSimpleExtentDims(dims);
+        bool bandLast = ras->bandLast;
+        long int nb = bandLast ? dims[2] : dims[0];
+        long int n = slice.getCountX() * slice.getCountY();
+        buffer.resize(n * nb);
+        if (n == 0) return;
+
+        if (slice.getX0() < 0 || slice.getY0() < 0 ||
+            slice.getX0() + slice.getDeltaX() > ras->get_nx() || slice.getY0() + slice.getDeltaY() > ras->get_ny())
+            throw_RasterReadError(ras->fullRastername + " readBandStack: slice outside raster");
+
+        if (bandLast != (layout == Image::LAYOUT_BIP)) {
+            // the other order: each band into its place, from the same (cached) chunks
+            for (long int b = 0; b < nb; b++) {
+                ras->band = b;
+                try {
+                    if (layout == Image::LAYOUT_BSQ) ras->read(slice, &buffer[b*n]);
+                    else                             ras->read(slice, &buffer[b], nb);
+                } catch (...) {
+                    ras->band = 0;
+                    throw;
+                }
+            }// endfor
+            ras->band = 0;
+            return;
+        }
+
+        // the stack's own order: one read of the whole window, all bands
+        hsize_t start[3], count[3], stride[3];
+        int yDim = bandLast ? 0 : 1;
+        int bandDim = bandLast ? 2 : 0;
+        start[yDim] = slice.getY0();
+        start[yDim+1] = slice.getX0();
+        start[bandDim] = 0;
+        count[yDim] = slice.getCountY();
+        count[yDim+1] = slice.getCountX();
+        count[bandDim] = nb;
+        stride[yDim] = std::max(1L, slice.getStrideY());
+        stride[yDim+1] = std::max(1L, slice.getStrideX());
+        stride[bandDim] = 1;
+        try {
+            dataspace.selectHyperslab(H5S_SELECT_SET, count, start, stride);
+            H5::DataSpace memspace(3, count);
+            ras->rasterobj->read(&buffer[0], Raster::getHdf5Type<T>(), memspace, dataspace);
+        } catch (const H5::Exception &e) {
+            throw_RasterReadError(ras->fullRastername + "  " + e.getDetailMsg());
+        }
+    }// end: readBandStack
+
+
+
     bool Image::datasetExists(const std::string &name) {
         try{
             H5::Exception::dontPrint();
@@ -163,38 +311,10 @@ namespace GeoStar {
 
 
             // 4. fill raster:
-            switch(rasterTyp) {
-                case INT8U:
-                    fill_raster<uint8_t>(ras, poBand, nx, ny, typ);
-                    break;
-                    /*
-                     case INT8S:
-                     fill_raster<int8_t>(ras, poBand, nx, ny, typ);
-                     case INT16U:
-                     fill_raster<uint16_t>(ras, poBand, nx, ny, typ);
-                     case INT16S:
-                     fill_raster<int16_t>(ras, poBand, nx, ny, typ);
-                     case INT32U:
-                     fill_raster<uint32_t>(ras, poBand, nx, ny, typ);
-                     case INT32S:
-                     fill_raster<int32_t>(ras, poBand, nx, ny, typ);
-                     case INT64U:
-                     fill_raster<uint64_t>(ras, poBand, nx, ny, typ);
-                     case INT64S:
-                     fill_raster<int64_t>(ras, poBand, nx, ny, typ);
-                     */
-                case REAL32:
-                    fill_raster<float>(ras, poBand, nx, ny, typ);
-                    break;
-                case REAL64:
-                    fill_raster<double>(ras, poBand, nx, ny, typ);
-                    break;
-                    //case COMPLEX_INT16:
-                    //    return ...
-                default:
-                    //throw RasterUnsupportedTypeError;
-                    fill_raster<double>(ras, poBand, nx, ny, typ);
-            }
+            visitRasterType(rasterTyp, [&](auto tag) {
+                typedef typename decltype(tag)::type T;
+                fill_raster<T>(ras, poBand, nx, ny, typ);
+            }, ras->getFullRasterName());
             rasters[i] = ras;
         }  // end for
           
@@ -220,7 +340,7 @@ namespace GeoStar {
                                           &buf[0], nx, 1, typ,   // &buf[0] for parameter void *
                                           0, 0 );
             slice.setY0(iy);
-            ras->write(slice,buf);
+            ras->write(slice,&buf[0]);
         } // endfor
         return;
     }
@@ -237,7 +357,7 @@ namespace GeoStar {
         
         for(int iy=0;iy<ny;++iy){
             slice.setY0(iy);
-            ras->read(slice, buf);
+            ras->read(slice, &buf[0]);
             // write internal raster buffer to the gdal raster band.
             CPLErr err = poBand->RasterIO( GF_Write,
                                           0, iy, nx, 1,
@@ -295,38 +415,14 @@ namespace GeoStar {
      
             poBand = poDstMem->GetRasterBand(i+1);
      
-            switch(typ) {
-                case GDT_Byte:
-                    copy_raster<uint8_t>(ras, poBand, nx, ny, typ);
-                    break;
-     
-                    //case GDT_UInt16:
-                    //copy_raster<uint16_t>(ras, poBand, nx, ny, typ);
-                    //case GDT_Int16:
-                    //copy_raster<int16_t>(ras, poBand, nx, ny, typ);
-                    //case GDT_UInt32:
-                    //copy_raster<uint32_t>(ras, poBand, nx, ny, typ);
-                    //case GDT_Int32:
-                    //copy_raster<int32_t>(ras, poBand, nx, ny, typ);
-     
-                case GDT_Float32:
-                    copy_raster<float>(ras, poBand, nx, ny, typ);
-                    break;
-                case GDT_Float64:
-                    copy_raster<double>(ras, poBand, nx, ny, typ);
-                    break;
-                    //case GDT_CInt16:
-                    //    return ...COMPLEX_INT32
-                    //case GDT_CInt32:
-                    //    return ...COMPLEX_INT64
-                    //case GDT_CFloat32:
-                    //    return ...COMPLEX_REAL64
-                    //case GDT_CFloat64:
-                    //    return ...COMPLEX_REAL128
-                default:
-                    //throw RasterUnsupportedTypeError;
-                    copy_raster<double>(ras, poBand, nx, ny, typ);
-            }
+            // copy in the raster's own type; GDAL converts to the band type if the channels differ.
+            // GDAL has no signed 8-bit or 64-bit integer bands: those come out as GDT_Float64 (see getGDALType)
+            GDALDataType bufTyp = getGDALType(ras);
+            visitRasterType(ras->getRasterType(), [&](auto tag) {
+                typedef typename decltype(tag)::type T;
+                if (bufTyp == GDT_Float64) copy_raster<double>(ras, poBand, nx, ny, bufTyp);
+                else copy_raster<T>(ras, poBand, nx, ny, bufTyp);
+            }, ras->getFullRasterName());
         } // endfor
         poDriver = GetGDALDriverManager()->GetDriverByName(cformat);
         if( poDriver == NULL ) throw std::runtime_error("invalid GDAL driver");
@@ -352,6 +448,9 @@ namespace GeoStar {
             H5G_obj_t objType = imageobj->getObjTypeByIdx(i);
 
             if (objType == H5G_DATASET) {
+                // band stacks are 3D, and overviews are stored next to their raster; neither is a channel:
+                if (datasetObjectType(obj) != "geostar::raster") continue;
+                if (openDataset(obj).attrExists("overview_of")) continue;
                 channels[chIdx] = obj;
                 chIdx++;
             }
@@ -359,6 +458,60 @@ namespace GeoStar {
         channels.resize(chIdx);
         return channels;
     }
+
+
+
+    std::vector<std::string> Image::getBandStacks() {
+        std::vector<std::string> stacks;
+        int numObjs = imageobj->getNumObjs();
+        for (int i = 0; i < numObjs; i++) {
+            if (imageobj->getObjTypeByIdx(i) != H5G_DATASET) continue;
+            std::string obj = imageobj->getObjnameByIdx(i);
+            if (datasetObjectType(obj) == "geostar::bandstack") stacks.push_back(obj);
+        }// endfor
+        return stacks;
+    }
+
+
+
+    std::string Image::datasetObjectType(const std::string &name) {
+        H5::DataSet ds = openDataset(name);
+        if (!ds.attrExists("object_type")) return "";
+        return GeoStar::read_object_type(&ds);
+    }
+
+
+
+    void Image::openLayers(std::vector<Raster*> &rasters, std::vector<std::string> &outNames) {
+        std::vector<std::string> channels = getChannels();
+        for (size_t i = 0; i < channels.size(); i++) {
+            rasters.push_back(open_raster(channels[i]));
+            outNames.push_back(channels[i]);
+        }// endfor
+        std::vector<std::string> stacks = getBandStacks();
+        for (size_t i = 0; i < stacks.size(); i++) {
+            int nbands = get_band_count(stacks[i]);
+            for (int b = 0; b < nbands; b++) {
+                rasters.push_back(open_band(stacks[i], b));
+                outNames.push_back(stacks[i] + "_band" + std::to_string(b));
+            }// endfor: b
+        }// endfor
+    }
+
+
+
+    std::vector<std::string> Image::getOverviews(const std::string &name) {
+        std::vector<std::string> overviews;
+        int numObjs = imageobj->getNumObjs();
+        for (int i = 0; i < numObjs; i++) {
+            if (imageobj->getObjTypeByIdx(i) != H5G_DATASET) continue;
+            std::string obj = imageobj->getObjnameByIdx(i);
+            H5::DataSet ds = openDataset(obj);
+            if (ds.attrExists("overview_of") && GeoStar::read_attribute(&ds, "overview_of") == name)
+                overviews.push_back(obj);
+        }// endfor
+        return overviews;
+    }
     
     
     GDALDataType Image::getGDALType(const Raster *ras) {
@@ -435,11 +588,14 @@ namespace GeoStar {
     Image* Image::rotate(const float angle) {
         std::string newImgName = imagename+"ROTATE_"+std::to_string(angle);
         Image *imgNew = new Image(ownerFile, newImgName);
-        std::vector<std::string> channels = getChannels();
-        for (int i = 0; i < channels.size(); i++) {
-            Raster *ras = open_raster(channels[i]);
-            Raster *newRas = imgNew->create_raster(ras->getRasterName(), ras->getRasterType());
-            ras->rotate(angle, newRas);
+        std::vector<Raster*> rasters;
+        std::vector<std::string> outNames;
+        openLayers(rasters, outNames);
+        for (size_t i = 0; i < rasters.size(); i++) {
+            Raster *newRas = imgNew->create_raster(outNames[i], rasters[i]->getRasterType());
+            rasters[i]->rotate(angle, newRas);
+            delete newRas;
+            delete rasters[i];
         }
         return imgNew;
     }
@@ -447,33 +603,43 @@ namespace GeoStar {
     Image* Image::rotate(const float angle, const Slice &inslice) {
         std::string newImageName = imagename+"ROTATE_"+std::to_string(angle);
         Image *imgNew = new Image(ownerFile, newImageName);
-        std::vector<std::string> channels = getChannels();
-        for (int i = 0; i < channels.size(); i++) {
-            Raster *ras = open_raster(channels[i]);
-            Raster *newRas = imgNew->create_raster(ras->getRasterName(), ras->getRasterType());
-            ras->rotate(angle, inslice, newRas);
+        std::vector<Raster*> rasters;
+        std::vector<std::string> outNames;
+        openLayers(rasters, outNames);
+        for (size_t i = 0; i < rasters.size(); i++) {
+            Raster *newRas = imgNew->create_raster(outNames[i], rasters[i]->getRasterType());
+            rasters[i]->rotate(angle, inslice, newRas);
+            delete newRas;
+            delete rasters[i];
         }
         return imgNew;
     }
     
     Image* Image::flip(const std::string &newImageName, short flipAxis) {
         Image *imgNew = new Image(ownerFile, newImageName);
-        std::vector<std::string> channels = getChannels();
-        for (int i = 0; i < channels.size(); i++) {
-            Raster *ras = open_raster(channels[i]);
-            Raster *newRas = imgNew->create_raster(ras->getRasterName(), ras->getRasterType(), ras->get_nx(), ras->get_ny());
+        std::vector<Raster*> rasters;
+        std::vector<std::string> outNames;
+        openLayers(rasters, outNames);
+        for (size_t i = 0; i < rasters.size(); i++) {
+            Raster *ras = rasters[i];
+            Raster *newRas = imgNew->create_raster(outNames[i], ras->getRasterType(), ras->get_nx(), ras->get_ny());
             ras->flip(newRas, flipAxis);
+            delete newRas;
+            delete ras;
         }
         return imgNew;
     }
     
     Image* Image::transform(std::string &newWKT, std::string &newImageName, double newDeltaX, double newDeltaY) {
         Image *imgNew = new Image(ownerFile, newImageName);
-        std::vector<std::string> channels = getChannels();
-        for (int i = 0; i < channels.size(); i++) {
-            Raster *ras = open_raster(channels[i]);
-            Raster *newRas = imgNew->create_raster(ras->getRasterName(), ras->getRasterType());
-            ras->transform(newWKT, newDeltaX, newDeltaY, newRas);
+        std::vector<Raster*> rasters;
+        std::vector<std::string> outNames;
+        openLayers(rasters, outNames);
+        for (size_t i = 0; i < rasters.size(); i++) {
+            Raster *newRas = imgNew->create_raster(outNames[i], rasters[i]->getRasterType());
+            rasters[i]->transform(newWKT, newDeltaX, newDeltaY, newRas);
+            delete newRas;
+            delete rasters[i];
         }
         return imgNew;
     }
@@ -482,9 +648,7 @@ namespace GeoStar {
     // Copy this Image to a new Image, under the same file, with the given name.
     // All channels (Rasters) will be copied.  The reference to the new copied Image is returned.
     Image* Image::copy_to(const std::string &newImageName) {
-        // Get the list of all this Image's channels (Rasters):
-        std::vector<std::string> channels = getChannels();
-        return copy_to(newImageName, channels);
+        return copy_to(ownerFile, newImageName);
     }
     
     
@@ -492,15 +656,53 @@ namespace GeoStar {
     // strings given, is the names of the channels of this Image, which should be copied under the
     // new Image.  The reference to the new copied Image is returned.
     Image* Image::copy_to(const std::string &newImageName, std::vector<std::string> &copyChannels) {
-        // First get a list of actual channels, to verify against given list of 'copy-from' channels:
-        //std::vector<std::string> channels = getChannels();  // MAY NOT NEED TO DO
-        Image *imgNew = new Image(ownerFile, newImageName);
-        for (int i = 0; i < copyChannels.size(); i++) {
-            Raster *ras = open_raster(copyChannels[i]);
-            Raster *newRas = imgNew->create_raster(ras->getRasterName(), ras->getRasterType(),
-                                                   ras->get_nx(), ras->get_ny());
-            ras->copy(newRas);
-        }
+        return copy_to(ownerFile, newImageName, copyChannels);
+    }
+
+
+
+    Image* Image::copy_to(File *file, const std::string &newImageName) {
+        // Get the list of all this Image's channels (Rasters):
+        std::vector<std::string> channels = getChannels();
+        std::vector<std::string> stacks = getBandStacks();
+        channels.insert(channels.end(), stacks.begin(), stacks.end());
+        return copy_to(file, newImageName, channels);
+    }
+
+
+
+    Image* Image::copy_to(File *file, const std::string &newImageName, std::vector<std::string> &copyChannels) {
+        Image *imgNew = new Image(file, newImageName);
+
+        // the overviews of a channel go with it, so its "overviews" attribute stays true:
+        std::vector<std::string> names = copyChannels;
+        for (size_t i = 0; i < copyChannels.size(); i++) {
+            if (!datasetExists(copyChannels[i])) continue;   // (reported below)
+            std::vector<std::string> overviews = getOverviews(copyChannels[i]);
+            names.insert(names.end(), overviews.begin(), overviews.end());
+        }// endfor
+
+        // H5Ocopy copies the stored chunks as they are, within a file or across files.
+        //  Committed datatypes are merged, so a 10-band copy doesn't repeat them:
+        hid_t ocpypl = H5Pcreate(H5P_OBJECT_COPY);
+        H5Pset_copy_object(ocpypl, H5O_COPY_MERGE_COMMITTED_DTYPE_FLAG);
+        for (size_t i = 0; i < names.size(); i++) {
+            const std::string &name = names[i];
+            if (!datasetExists(name)) {
+                H5Pclose(ocpypl);
+                throw_RasterDoesNotExistError(fullImagename+"/"+name);
+            }
+            if (imgNew->datasetExists(name)) {
+                H5Pclose(ocpypl);
+                throw_RasterExistsError(imgNew->getFullImagename()+"/"+name);
+            }
+            if (H5Ocopy(imageobj->getId(), name.c_str(), imgNew->imageobj->getId(), name.c_str(),
+                        ocpypl, H5P_DEFAULT) < 0) {
+                H5Pclose(ocpypl);
+                throw_RasterWriteError(imgNew->getFullImagename()+"/"+name+"  H5Ocopy failed");
+            }
+        }// endfor
+        H5Pclose(ocpypl);
         return imgNew;
     }
 
@@ -515,18 +717,33 @@ namespace GeoStar {
     
     void Image::setWKT(std::string &wkt) {
         std::vector<std::string> channels = getChannels();
-        for (int i = 0; i < channels.size(); i++) {
+        for (size_t i = 0; i < channels.size(); i++) {
             Raster *ras = open_raster(channels[i]);
             ras->setWKT(wkt);
+            delete ras;
+        }
+        // the attributes of a band stack are on its dataset, shared by all its bands:
+        std::vector<std::string> stacks = getBandStacks();
+        for (size_t i = 0; i < stacks.size(); i++) {
+            Raster *ras = open_band(stacks[i], 0);
+            ras->setWKT(wkt);
+            delete ras;
         }
         return;
     }
     
     void Image::setLocation(std::string &location) {
         std::vector<std::string> channels = getChannels();
-        for (int i = 0; i < channels.size(); i++) {
+        for (size_t i = 0; i < channels.size(); i++) {
             Raster *ras = open_raster(channels[i]);
             ras->setLocation(location);
+            delete ras;
+        }
+        std::vector<std::string> stacks = getBandStacks();
+        for (size_t i = 0; i < stacks.size(); i++) {
+            Raster *ras = open_band(stacks[i], 0);
+            ras->setLocation(location);
+            delete ras;
         }
         return;
     }
@@ -547,12 +764,48 @@ namespace GeoStar {
     }
      */
     template void Image::fill_raster<uint8_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<int8_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<uint16_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<int16_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<uint32_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<int32_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<uint64_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::fill_raster<int64_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
     template void Image::fill_raster<float>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
     template void Image::fill_raster<double>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
 
     template void Image::copy_raster<uint8_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<int8_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<uint16_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<int16_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<uint32_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<int32_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<uint64_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
+    template void Image::copy_raster<int64_t>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
     template void Image::copy_raster<float>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
     template void Image::copy_raster<double>(Raster*, GDALRasterBand*, const int, const int, const GDALDataType);
 
+    template void Image::readBands<uint8_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<uint8_t>&);
+    template void Image::readBands<int8_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<int8_t>&);
+    template void Image::readBands<uint16_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<uint16_t>&);
+    template void Image::readBands<int16_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<int16_t>&);
+    template void Image::readBands<uint32_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<uint32_t>&);
+    template void Image::readBands<int32_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<int32_t>&);
+    template void Image::readBands<uint64_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<uint64_t>&);
+    template void Image::readBands<int64_t>(const Slice&, const std::vector<std::string>&, const short, std::vector<int64_t>&);
+    template void Image::readBands<float>(const Slice&, const std::vector<std::string>&, const short, std::vector<float>&);
+    template void Image::readBands<double>(const Slice&, const std::vector<std::string>&, const short, std::vector<double>&);
+
+    template void Image::readBandStack<uint8_t>(const std::string&, const Slice&, const short, std::vector<uint8_t>&);
+    template void Image::readBandStack<int8_t>(const std::string&, const Slice&, const short, std::vector<int8_t>&);
+    template void Image::readBandStack<uint16_t>(const std::string&, const Slice&, const short, std::vector<uint16_t>&);
+    template void Image::readBandStack<int16_t>(const std::string&, const Slice&, const short, std::vector<int16_t>&);
+    template void Image::readBandStack<uint32_t>(const std::string&, const Slice&, const short, std::vector<uint32_t>&);
+    template void Image::readBandStack<int32_t>(const std::string&, const Slice&, const short, std::vector<int32_t>&);
+    template void Image::readBandStack<uint64_t>(const std::string&, const Slice&, const short, std::vector<uint64_t>&);
+    template void Image::readBandStack<int64_t>(const std::string&, const Slice&, const short, std::vector<int64_t>&);
+    template void Image::readBandStack<float>(const std::string&, const Slice&, const short, std::vector<float>&);
+    template void Image::readBandStack<double>(const std::string&, const Slice&, const short, std::vector<double>&);
+
 
 }// end namespace GeoStar
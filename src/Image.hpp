@@ -9,9 +9,11 @@
 #define IMAGE_HPP_
 
 #include <string>
+#include <map>
 
 #include "H5Cpp.h"
 #include "Raster.hpp"
+#include "SharedTileCache.hpp"
 #include "attributes.hpp"
 
 #include "gdal_priv.h"
@@ -55,6 +57,18 @@ There are tools to check if a dataset exists before creating or opening one.
     RasterType getGeoStarType(const GDALDataType &type);
     GDALDataType getGDALType(const Raster *ras);
       File *ownerFile;
+
+      // the object_type of the named dataset ("" if it has none)
+      std::string datasetObjectType(const std::string &name);
+
+      // open every raster of this image that an image-wide operation (rotate, flip, ...) works on:
+      //  each channel, and each band of each band stack.  outNames gets the name of each one's
+      //  result: the channel's own name, or "<stack>_band<k>" for band k of a stack.
+      void openLayers(std::vector<Raster*> &rasters, std::vector<std::string> &outNames);
+
+      // rasters opened by readBands, kept open for the next call (deleted with the Image)
+      std::map<std::string, Raster*> bandRasters;
+      Raster *bandRaster(const std::string &name);
       
       // For now, this is a private function.  May make sense to later allow public access (?)
       //void moveRaster(Image *otherImg, Raster *raster);
@@ -216,6 +230,11 @@ There are tools to check if a dataset exists before creating or opening one.
           return fullImagename;
       }
 
+      // the File this image is in
+      inline File *getFile() const {
+          return ownerFile;
+      }
+
     /** \brief Image destructor allows one to delete a Raster object from memory.
 
    The Image destructor is automatically called to clean up memory used by the Image object.
@@ -250,6 +269,8 @@ There are tools to check if a dataset exists before creating or opening one.
 
   */
     inline ~Image() {
+      for (std::map<std::string, Raster*>::iterator it = bandRasters.begin(); it != bandRasters.end(); ++it)
+        delete it->second;
       delete imageobj;
     }
 
@@ -275,6 +296,12 @@ There are tools to check if a dataset exists before creating or opening one.
    \param[in] ny
 	this is the size of the raster in the y-direction.
 
+   \param[in] layout
+	Optional storage layout: chunk size, and the shuffle, deflate and n-bit filters.
+	The default, RasterLayout(), uses 256 X 256 chunks with shuffle+deflate, which suits large
+	scenes.  Pass RasterLayout::contiguous() for unchunked, uncompressed storage, or e.g.
+	RasterLayout(512,512) for bigger chunks.
+
    \returns
        A valid Raster object on success.
 
@@ -297,6 +324,12 @@ There are tools to check if a dataset exists before creating or opening one.
   	GeoStar::Raster *ras;
 	ras = img->create_raster("test", GeoStar::REAL32, 400, 400);
 
+	// 512x512 chunks, shuffle + deflate level 6:
+	GeoStar::Raster *ras2;
+	ras2 = img->create_raster("test2", GeoStar::REAL32, 20000, 20000, GeoStar::RasterLayout(512,512,true,6));
+
+	delete ras2;
+
 	delete ras;
 	delete img;
 	delete file;
@@ -311,16 +344,66 @@ There are tools to check if a dataset exists before creating or opening one.
   */
     inline Raster *create_raster(const std::string &name, 
                                  const RasterType &type,
-                                 const int &nx, const int &ny) {
-      return new Raster(this,name,type,nx,ny);
+                                 const int &nx, const int &ny,
+                                 const RasterLayout &layout = RasterLayout()) {
+      return new Raster(this,name,type,nx,ny,layout);
     }
 
+      // create a raster whose size can be changed later (Raster::setSize); always chunked
       inline Raster *create_raster(const std::string &name,
-                                   const RasterType &type) {
-          return new Raster(this,name,type);
+                                   const RasterType &type,
+                                   const RasterLayout &layout = RasterLayout()) {
+          return new Raster(this,name,type,layout);
       }
 
 
+
+    /** \brief create_scratch_raster creates a temporary raster, outside of this image's file.
+
+   Image::create_scratch_raster makes a raster for intermediate results, that is never stored in
+   the user's GeoStar file.  It is deleted, with all of its data, when the Raster object is deleted.
+
+   \see  create_raster, File::create_scratch, File::set_scratch_budget
+
+   \param[in] name
+       The name of the new raster; only used in messages.
+
+   \param[in] type
+       The RasterType of the new raster.
+
+   \param[in] nx
+       The number of pixels in the x-direction.
+
+   \param[in] ny
+       The number of pixels in the y-direction.
+
+   \returns
+       A valid Raster object on success, which the caller must delete.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       FileAccessException
+       RasterCreationImmutableError
+
+   \par Example
+       \code
+       GeoStar::Raster *tmp = img->create_scratch_raster("tmp", GeoStar::REAL32, nx, ny);
+       ras->FFT_2D(img, tmp, tmpImg);
+       ...
+       delete tmp;        // no trace is left in img's file
+       \endcode
+
+    \par Details
+       The raster lives in its own private HDF5 file: in memory (HDF5 "core" driver) when it fits
+       in the scratch budget, and otherwise in a file in the system temporary directory, which
+       is removed when the raster is deleted.
+       In memory the raster is contiguous; on disk it is chunked, but not compressed.
+       Scratch rasters are otherwise ordinary rasters, and can be used with any Raster method.
+  */
+      Raster *create_scratch_raster(const std::string &name, const RasterType &type,
+                                    const int &nx, const int &ny);
+
+
     /** \brief open_raster allows one to open an existing GeoStar raster.
 
    Image::open_raster is used to open an existing raster in a GeoStar Image.
@@ -372,6 +455,92 @@ There are tools to check if a dataset exists before creating or opening one.
 
 
 
+    /** \brief create_band_stack creates a multi-band raster, stored as one 3D dataset.
+
+   Image::create_band_stack makes a dataset that holds nbands bands of the same size and type,
+   either band sequential ([band][y][x]) or band interleaved by pixel ([y][x][band]).  The bands
+   are then used, one at a time, with open_band, or all together with readBandStack.
+
+   \see  open_band, get_band_count, readBandStack, create_raster
+
+   \param[in] name
+       The name of the new dataset.
+
+   \param[in] type
+       The pixel type of every band.
+
+   \param[in] nx, ny
+       The size of each band, in pixels.
+
+   \param[in] nbands
+       The number of bands.
+
+   \param[in] interleave
+       LAYOUT_BSQ for [band][y][x], LAYOUT_BIP for [y][x][band].
+
+   \param[in] layout
+       Chunking and compression.  A chunk always holds every band of its block of pixels, so the
+       chunk width and height are reduced, if needed, to keep chunks a reasonable size.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterExistsError
+       RasterSizeError
+       RasterCreationImmutableError, also for an invalid interleave.
+
+   \par Example
+       \code
+       img->create_band_stack("ms", GeoStar::INT16U, 4096, 4096, 8, GeoStar::Image::LAYOUT_BIP,
+                              GeoStar::RasterLayout(256,256,true,4));
+       GeoStar::Raster *nir = img->open_band("ms", 7);
+       \endcode
+
+    \par Details
+       Pixel-interleaved stacks suit per-pixel work on all bands (classification, band ratios),
+       since a window of every band is one contiguous read; band-sequential stacks suit work on
+       one band at a time.  Either way, one chunk read serves all bands of its block.
+  */
+      void create_band_stack(const std::string &name, const RasterType &type, const int &nx, const int &ny,
+                             const int &nbands, const short interleave, const RasterLayout &layout=RasterLayout());
+
+    /** \brief open_band opens one band of a band stack, as a Raster.
+
+   The returned Raster is a view onto one band plane of the stack: reads and writes (and the
+   operations built on them) go to that band only.  It cannot be resized.
+
+   \see  create_band_stack, get_band_count
+
+   \param[in] name
+       The name of the band stack.
+
+   \param[in] band
+       The band, from 0 to get_band_count(name)-1.
+
+   \returns
+       A pointer to the new Raster, which the caller deletes.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterDoesNotExistError
+       RasterOpenError, if the dataset is not a band stack or the band is out of range.
+
+   \par Example
+       \code
+       GeoStar::Raster *red = img->open_band("ms", 3);
+       \endcode
+  */
+    Raster *open_band(const std::string &name, const int &band) {
+      return new Raster(this,name,band);
+    }
+
+      // the number of bands in a band stack
+      int get_band_count(const std::string &name);
+
+
+
 
     /** \brief delete_raster attempts to delete a raster with the given name from the image.
 
@@ -413,6 +582,16 @@ There are tools to check if a dataset exists before creating or opening one.
         simply does nothing.
     */
      void delete_raster(const std::string &name) {
+      // readBands keeps channels open by name, readBandStack keeps band stacks as name/band0:
+      const std::string keys[2] = {name, name + "/band0"};
+      for (int k = 0; k < 2; k++) {
+        std::map<std::string, Raster*>::iterator it = bandRasters.find(keys[k]);
+        if (it != bandRasters.end()) {
+          delete it->second;
+          bandRasters.erase(it);
+        }
+      }
+      SharedTileCache::instance().invalidate(fullImagename+"/"+name);
       H5Ldelete(this->imageobj->getLocId(), name.c_str(), H5P_DEFAULT);
       return;
     }
@@ -593,6 +772,11 @@ There are tools to check if a dataset exists before creating or opening one.
       return imageobj->openDataSet(name);
     }
 
+      // open the named dataset, with the given dataset access properties (e.g. a chunk cache)
+      inline H5::DataSet openDataset(const std::string &name, const H5::DSetAccPropList &dapl) {
+          return imageobj->openDataSet(name, dapl);
+      }
+
 
 /** \brief read_file reads a file and returns a new raster
 
@@ -668,7 +852,96 @@ There are tools to check if a dataset exists before creating or opening one.
       void write_file(const std::string &outfile, const std::string &format, std::vector<std::string> &channels);
 
       int getNumberOfChannels(const std::string &infile);
+      // the names of the channels (rasters) of this image; overviews (see Raster::buildOverviews)
+      //  and band stacks (see create_band_stack) are not channels
       std::vector<std::string> getChannels();
+
+      // the names of the band stacks of this image
+      std::vector<std::string> getBandStacks();
+
+      // the names of the overview datasets of the named dataset (see Raster::buildOverviews)
+      std::vector<std::string> getOverviews(const std::string &name);
+
+      static const short LAYOUT_BSQ = 1;    // band sequential: all of band 0, then all of band 1, ...
+      static const short LAYOUT_BIP = 2;    // band interleaved by pixel: all bands of pixel 0, then pixel 1, ...
+
+    /** \brief readBands reads the same window of several channels into one buffer.
+
+   Image::readBands reads the slice from each of the named channels (rasters) of this image, and
+   returns them together, either band sequential (BSQ) or band interleaved by pixel (BIP).
+
+   \see  Raster::read, getChannels
+
+   \param[in] slice
+       The window to read, the same in every channel (strides are honoured, see Raster::read).
+
+   \param[in] channels
+       The names of the channels to read, in output band order.
+
+   \param[in] layout
+       LAYOUT_BSQ: buffer[b*n + i] is pixel i of band b, n = slice.getCountX()*slice.getCountY().
+       LAYOUT_BIP: buffer[i*nb + b] is pixel i of band b, nb = channels.size().
+
+   \param[out] buffer
+       The pixels of all the bands; resized to n*nb.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterDoesNotExistError
+       RasterReadError, also for an invalid layout.
+
+   \par Example
+       Read an RGB+NIR window, pixel-interleaved:
+       \code
+       std::vector<std::string> bands = {"red", "green", "blue", "nir"};
+       std::vector<float> pixels;
+       img->readBands(GeoStar::Slice(0,0,512,512), bands, GeoStar::Image::LAYOUT_BIP, pixels);
+       \endcode
+
+    \par Details
+       The channels are opened on the first call and stay open for later calls, until the Image is
+       deleted (or the channel is removed with delete_raster).
+       Each band is read straight into its place in the output buffer (a strided read for BIP), so
+       there is no separate interleaving pass.
+  */
+      template <typename T>
+      void readBands(const Slice &slice, const std::vector<std::string> &channels, const short layout,
+                     std::vector<T> &buffer);
+
+    /** \brief readBandStack reads the same window of every band of a band stack into one buffer.
+
+   \see  create_band_stack, readBands
+
+   \param[in] name
+       The name of the band stack.
+
+   \param[in] slice
+       The window to read, the same in every band (strides are honoured, see Raster::read).
+
+   \param[in] layout
+       LAYOUT_BSQ or LAYOUT_BIP, as for readBands.
+
+   \param[out] buffer
+       The pixels of all the bands; resized to n*nbands.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterDoesNotExistError
+       RasterOpenError, if the dataset is not a band stack.
+       RasterReadError, also for an invalid layout.
+
+   \par Details
+       When the requested layout is the stack's own interleave this is a single HDF5 read.
+       Otherwise each band is read into its place in the buffer, from the same chunks.
+  */
+      template <typename T>
+      void readBandStack(const std::string &name, const Slice &slice, const short layout, std::vector<T> &buffer);
       
       Image* scale(const double &xratio, const double &yratio);
       //Raster* scale(const long int &nx, const long int &ny);
@@ -684,6 +957,14 @@ There are tools to check if a dataset exists before creating or opening one.
       //Raster* warp(const WarpParameters warpData, const Slice &in, const Slice &out, Raster *outRaster);
       //Raster* transform(std::string &newWKT, std::string &newRasterName, double newDeltaX, double newDeltaY);
       
+      // rotate, flip and transform make a new image with one raster for each channel of this one;
+      //  each band k of a band stack "ms" becomes a raster "ms_band<k>".  For example:
+      //
+      //    img->create_raster("pan", GeoStar::INT16U, 8192, 8192);
+      //    img->create_band_stack("ms", GeoStar::INT16U, 2048, 2048, 4, GeoStar::Image::LAYOUT_BIP);
+      //    GeoStar::Image *rotated = img->rotate(0.3);   // rasters pan, ms_band0, ..., ms_band3
+      //
+      //  setWKT and setLocation set the attribute once for each channel and each band stack.
       Image* rotate(const float angle);  // done
       Image* rotate(const float angle, const Slice &in);  // done
       Image* warp(const WarpParameters warpData, const Slice &in, const Slice &out, Image *outImage); // or outName?
@@ -693,7 +974,7 @@ There are tools to check if a dataset exists before creating or opening one.
       void setLocation(std::string &location);  //done
       
       // Copy this Image to a new Image, under the same file, with the given name.
-      // All channels (Rasters) will be copied.  The reference to the new copied Image is returned.
+      // All channels (Rasters) and band stacks will be copied.  The reference to the new copied Image is returned.
       Image* copy_to(const std::string &newImageName);
       
       // Copy this Image to a new Image, under the same file, with the given name.  The vector of
@@ -701,6 +982,13 @@ There are tools to check if a dataset exists before creating or opening one.
       // new Image.  The reference to the new copied Image is returned.
       Image* copy_to(const std::string &newImageName, std::vector<std::string> &copyChannels);
 
+      // The same, into an Image of another File (or this one).
+      // Channels are copied by HDF5 as stored (H5Ocopy): chunks are not decompressed and
+      // compressed again, unallocated chunks stay unallocated, and the channels' attributes
+      // (location, wkt, ...) come along.
+      Image* copy_to(File *file, const std::string &newImageName);
+      Image* copy_to(File *file, const std::string &newImageName, std::vector<std::string> &copyChannels);
+
 
   }; // end class: Image
   
@@ -10,6 +10,9 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 #include "H5Cpp.h"
 
@@ -19,6 +22,8 @@
 #include "Slice.hpp"
 #include "WarpParameters.hpp"
 #include "TileIO.hpp"
+#include "TileWriter.hpp"
+#include "SharedTileCache.hpp"
 #include "Exceptions.hpp"
 #include "attributes.hpp"
 
@@ -41,15 +46,36 @@ namespace GeoStar {
       fullRastername = image->getFullImagename()+"/"+name;
       rastertype = "geostar::raster";
       this->image = image;
+      scratchFile = NULL;
+      scratchImage = NULL;
+      band = -1;
+      bandLast = false;
+      appendRow = -1;
+      appendCapacity = 0;
+      pendingRows = 0;
       
       H5::DataType type = rasterobj->getDataType();
       raster_datatype = getRasterType(type);
   }// end-Raster-constructor
 
 
+
+  Raster::~Raster() {
+      // destructors must not throw; a failed final write is lost, as with any unclosed file:
+      try {
+          finishAppend();
+      } catch (...) {
+      }
+      delete rasterobj;
+      // a scratch raster owns its private image and file, which go away with it:
+      delete scratchImage;
+      delete scratchFile;
+  }// end-Raster-destructor
+
+
     
     // Creating a new dataset/raster, with CHANGEABLE (or "mutable") dimensions:
-    Raster::Raster(Image *image, const std::string &name, const RasterType &type) {
+    Raster::Raster(Image *image, const std::string &name, const RasterType &type, const RasterLayout &layout) {
         
         //if(image->datasetExists(name)) throw_RasterExistsError(image->imageobj->getFileName()+image->imageobj->getObjName()+"/"+name);
         if(image->datasetExists(name)) throw_RasterExistsError(image->getFullImagename()+"/"+name);
@@ -66,16 +92,15 @@ namespace GeoStar {
         
         //
         //Modify dataset creation properties, i.e. enable chunking. ... This is to allow the dataspace size to be changeable
-        //  in the future ("mutable")!
+        //  in the future ("mutable")!  The chunk size and filters come from the layout; chunks are NOT clamped
+        //  to the (tiny) initial size, since the raster will be extended later.
         //
-        H5::DSetCreatPropList cparms;
-        hsize_t      chunk_dims[2] ={2, 5};
-        cparms.setChunk( 2, chunk_dims );
+        H5::DSetCreatPropList cparms = layout.createPropList(h5Type, dims[1], dims[0], true);
         
         
         try {
             //rasterobj = new H5::DataSet(image->createDataset(name, h5Type, dataspace));
-            rasterobj = new H5::DataSet(image->createDataset(name, h5Type, dataspace, cparms));
+            rasterobj = new H5::DataSet(image->createDataset(name, layout.storageType(h5Type), dataspace, cparms));
         } catch (H5::GroupIException e) {
             delete rasterobj;
             throw_RasterCreationMutableError(image->getFullImagename()+"/"+name+"  "+e.getDetailMsg());
@@ -88,6 +113,13 @@ namespace GeoStar {
         raster_datatype=type;
         rastertype = "geostar::raster";
         this->image = image;
+        scratchFile = NULL;
+        scratchImage = NULL;
+        band = -1;
+        bandLast = false;
+        appendRow = -1;
+        appendCapacity = 0;
+        pendingRows = 0;
 
         // set objtype attribute.
         write_object_type(rastertype);
@@ -98,7 +130,7 @@ namespace GeoStar {
 
     // Creating a new dataset/raster, with IMMUTABLE dimensions:
   Raster::Raster(Image *image, const std::string &name, const RasterType &type,
-           const int &nx, const int &ny) {
+           const int &nx, const int &ny, const RasterLayout &layout) {
 
       if(image->datasetExists(name))  throw_RasterExistsError(image->getFullImagename()+"/"+name);
 
@@ -110,8 +142,12 @@ namespace GeoStar {
      
       //    Get the Hdf5 type corresponding to the given GeoStar type:
       H5::PredType h5Type = this->hdf5Type(type);
+
+      // chunking and compression, as requested by the layout (contiguous if not chunked):
+      H5::DSetCreatPropList cparms = layout.createPropList(h5Type, nx, ny, false);
+
       try {
-          rasterobj = new H5::DataSet(image->createDataset(name, h5Type, dataspace));
+          rasterobj = new H5::DataSet(image->createDataset(name, layout.storageType(h5Type), dataspace, cparms));
       } catch (H5::GroupIException e) {
           delete rasterobj;
           throw_RasterCreationImmutableError(image->getFullImagename()+"/"+name+"  "+e.getDetailMsg());
@@ -125,6 +161,13 @@ namespace GeoStar {
       raster_datatype=type;
       rastertype = "geostar::raster";
       this->image = image;
+      scratchFile = NULL;
+      scratchImage = NULL;
+      band = -1;
+      bandLast = false;
+      appendRow = -1;
+      appendCapacity = 0;
+      pendingRows = 0;
     
       // set objtype attribute.
       write_object_type(rastertype);
@@ -133,27 +176,159 @@ namespace GeoStar {
 
   
 
+  // Opening one band of a band-stacked 3D dataset, as a view
+  Raster::Raster(Image *image, const std::string &stackName, const int &band) {
+
+      if(!image->datasetExists(stackName)) throw_RasterDoesNotExistError(image->getFullImagename()+"/"+stackName);
+
+      rasterobj = new H5::DataSet(image->openDataset(stackName));
+      if(read_object_type() != "geostar::bandstack") {
+          delete rasterobj;
+          throw_RasterOpenError(image->getFullImagename()+"/"+stackName);
+      }
+
+      bandLast = (GeoStar::read_attribute(rasterobj,"interleave") == "bip");
+      hsize_t dims[3];
+      rasterobj->getSpace().getSimpleExtentDims(dims);
+      long int nbands = bandLast ? dims[2] : dims[0];
+      if (band < 0 || band >= nbands) {
+          delete rasterobj;
+          throw_RasterOpenError(image->getFullImagename()+"/"+stackName+" band "+std::to_string(band));
+      }
+
+      // the dataset's name, so setChunkCache can reopen it; the band only shows in messages:
+      rastername = stackName;
+      fullRastername = image->getFullImagename()+"/"+stackName+"/band"+std::to_string(band);
+      rastertype = "geostar::raster";
+      this->image = image;
+      scratchFile = NULL;
+      scratchImage = NULL;
+      this->band = band;
+      appendRow = -1;
+      appendCapacity = 0;
+      pendingRows = 0;
+
+      H5::DataType type = rasterobj->getDataType();
+      raster_datatype = getRasterType(type);
+  }// end-Raster-constructor
+
+
+
+  void Raster::createBandStack(Image *image, const std::string &name, const RasterType &type,
+                               const int &nx, const int &ny, const int &nbands, const bool &bandLast,
+                               const RasterLayout &layout) {
+      if(image->datasetExists(name))  throw_RasterExistsError(image->getFullImagename()+"/"+name);
+      if(nx <= 0 || ny <= 0 || nbands <= 0) throw_RasterSizeError("in create_band_stack");
+
+      hsize_t dims[3];
+      if (bandLast) {
+          dims[0] = ny;
+          dims[1] = nx;
+          dims[2] = nbands;
+      } else {
+          dims[0] = nbands;
+          dims[1] = ny;
+          dims[2] = nx;
+      }
+      H5::DataSpace dataspace(3, dims);
+
+      //    Get the Hdf5 type corresponding to the given GeoStar type:
+      H5::PredType h5Type = visitRasterType(type, [&](auto tag) {
+          typedef typename decltype(tag)::type T;
+          return Raster::getHdf5Type<T>();
+      }, name);
+
+      // chunks hold every band of a block, so one chunk read serves all bands:
+      H5::DSetCreatPropList cparms = layout.createPropList(h5Type, nx, ny, nbands, bandLast);
+
+      H5::DataSet *stackobj = NULL;
+      try {
+          stackobj = new H5::DataSet(image->createDataset(name, layout.storageType(h5Type), dataspace, cparms));
+      } catch (const H5::Exception &e) {
+          delete stackobj;
+          throw_RasterCreationImmutableError(image->getFullImagename()+"/"+name+"  "+e.getDetailMsg());
+      }
+      GeoStar::write_object_type(stackobj, "geostar::bandstack");
+      GeoStar::write_attribute(stackobj, "interleave", bandLast ? "bip" : "bsq");
+      delete stackobj;
+  }// end: createBandStack
+
+
+
+  void Raster::selectWindow(H5::DataSpace &space, const H5S_seloper_t &op, const hsize_t start[2],
+                            const hsize_t count[2], const hsize_t stride[2]) const {
+      if (band < 0) {
+          space.selectHyperslab(op, count, start, stride);
+          return;
+      }
+
+      // one band plane of the 3D dataset:
+      hsize_t start3[3], count3[3], stride3[3];
+      int yDim = bandLast ? 0 : 1;
+      int bandDim = bandLast ? 2 : 0;
+      start3[yDim] = start[0];
+      start3[yDim+1] = start[1];
+      start3[bandDim] = band;
+      count3[yDim] = count[0];
+      count3[yDim+1] = count[1];
+      count3[bandDim] = 1;
+      stride3[yDim] = stride[0];
+      stride3[yDim+1] = stride[1];
+      stride3[bandDim] = 1;
+      space.selectHyperslab(op, count3, start3, stride3);
+  }// end: selectWindow
+
+
+
+  bool Raster::chunkSize(long int &chunkX, long int &chunkY) const {
+      H5::DSetCreatPropList cparms = rasterobj->getCreatePlist();
+      if (cparms.getLayout() != H5D_CHUNKED) return false;
+
+      hsize_t chunk_dims[3];
+      cparms.getChunk(3, chunk_dims);
+      int yDim = (band >= 0 && !bandLast) ? 1 : 0;
+      chunkY = chunk_dims[yDim];
+      chunkX = chunk_dims[yDim+1];
+      return true;
+  }// end: chunkSize
+
+
+
+  bool Raster::isBlankFill(const double &value) const {
+      // a band stack's storage is shared with the other bands:
+      if (band >= 0) return false;
+      return rasterobj->getStorageSize() == 0 && getFillValue() == value;
+  }// end: isBlankFill
+
+
+
   //returns the actual size of the raster in the x-direction
   long int Raster::get_nx() const {
       H5::DataSpace space=rasterobj->getSpace();
-      hsize_t dims[2];
+      hsize_t dims[3];
       space.getSimpleExtentDims(dims);
+      if (band >= 0 && !bandLast) return dims[2];
       return dims[1];
   }// end: get_nx
 
   //returns the actual size of the raster in the y-direction
   long int Raster::get_ny() const {
       H5::DataSpace space=rasterobj->getSpace();
-      hsize_t dims[2];
+      hsize_t dims[3];
       space.getSimpleExtentDims(dims);
+      if (band >= 0 && !bandLast) return dims[1];
       return dims[0];
   }// end: get_ny
     
     
     void Raster::setSize(long int nx, long int ny) {
+        // the bands of a band stack can't be resized on their own:
+        if (band >= 0) throw_RasterImmutableError(fullRastername);
         hsize_t dims[2];
         dims[0] = ny;
         dims[1] = nx;
+        // the tiles along the old edges change size:
+        SharedTileCache::instance().invalidate(fullRastername);
         try {
             rasterobj->extend(dims);
         } catch (H5::DataSetIException e) {
@@ -163,147 +338,485 @@ namespace GeoStar {
         return;
     }
 
+
+
+    template <typename T>
+    void Raster::appendRows(const std::vector<T> &buffer, const long int &nrows) {
+        if (nrows <= 0) return;
+        if (band >= 0) throw_RasterImmutableError(fullRastername);
+
+        long int nx = get_nx();
+        if ((long int)buffer.size() < nrows*nx)
+            throw_RasterWriteError(fullRastername + " appendRows: buffer smaller than nrows*nx");
+
+        if (appendRow < 0) {
+            // start appending after the rows already there; only growable rasters can:
+            hsize_t dims[2], maxdims[2];
+            rasterobj->getSpace().getSimpleExtentDims(dims, maxdims);
+            if (maxdims[0] != H5S_UNLIMITED) throw_RasterImmutableError(fullRastername);
+            appendRow = dims[0];
+            appendCapacity = dims[0];
+            pendingRows = 0;
+            pendingType = RasterTypeOf<T>::value;
+        } else if (pendingType != RasterTypeOf<T>::value) {
+            // the pending rows are in another type: write them all first
+            flushAppend(pendingRows);
+            pendingType = RasterTypeOf<T>::value;
+        }
+
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&buffer[0]);
+        pending.insert(pending.end(), bytes, bytes + nrows*nx*sizeof(T));
+        pendingRows += nrows;
+
+        // write every complete row of chunks, keep the rest:
+        long int chunkX, chunkY;
+        if (!chunkSize(chunkX, chunkY)) chunkY = 1;
+        long int lastBoundary = ((appendRow + pendingRows) / chunkY) * chunkY;
+        if (lastBoundary > appendRow) flushAppend(lastBoundary - appendRow);
+    }// end: appendRows
+
+
+
+    void Raster::flushAppend(const long int &nrows) {
+        if (nrows <= 0) return;
+        long int nx = get_nx();
+
+        // grow geometrically, in whole rows of chunks:
+        if (appendRow + nrows > appendCapacity) {
+            long int chunkX, chunkY;
+            if (!chunkSize(chunkX, chunkY)) chunkY = 1;
+            long int capacity = std::max(appendRow + nrows, std::max(2*appendCapacity, chunkY));
+            capacity = ((capacity + chunkY - 1) / chunkY) * chunkY;
+            setSize(nx, capacity);
+            appendCapacity = capacity;
+        }
+
+        hsize_t start[2], count[2];
+        start[0] = appendRow;
+        start[1] = 0;
+        count[0] = nrows;
+        count[1] = nx;
+        SharedTileCache::instance().invalidate(fullRastername, 0, appendRow, nx, nrows);
+        try {
+            H5::DataSpace dataspace = rasterobj->getSpace();
+            dataspace.selectHyperslab(H5S_SELECT_SET, count, start);
+            H5::DataSpace memspace(2, count);
+            rasterobj->write(&pending[0], hdf5Type(pendingType), memspace, dataspace);
+        } catch (const H5::Exception &e) {
+            throw_RasterWriteError(fullRastername + "  " + e.getDetailMsg());
+        }
+
+        // the rows left over go to the front of the buffer:
+        size_t written = pending.size() / pendingRows * nrows;
+        pending.erase(pending.begin(), pending.begin() + written);
+        appendRow += nrows;
+        pendingRows -= nrows;
+    }// end: flushAppend
+
+
+
+    void Raster::finishAppend() {
+        if (appendRow < 0) return;
+        flushAppend(pendingRows);
+        setSize(get_nx(), appendRow);
+        appendRow = -1;
+        appendCapacity = 0;
+        pendingRows = 0;
+        std::vector<unsigned char>().swap(pending);
+    }// end: finishAppend
+
     
     
   // in-place simple threshhold
   // < value : set to 0.
   void Raster::thresh(const double &value) {
-      long int nx = get_nx();
-      long int ny = get_ny();
-
-      Slice slice(0,0,nx,1);
-
-      std::vector<uint8_t> data(nx);
-
-      for(int line=0;line<ny;++line) {
-          slice.setY0(line);
-          read(slice,data);
-          for(int pixel=0; pixel<nx;++pixel) {
+      forEachBlock<uint8_t>(this, [&](const Slice &, std::vector<uint8_t> &data) {
+          for(size_t pixel=0; pixel<data.size();++pixel) {
               if(data[pixel] < value) data[pixel]=0;
           }// endfor: pixel
-          write(slice,data);
-      }// endfor: line
+      });
 
   }// end: thresh
     
     
     template<typename T>
-    void Raster::write(const Slice &outSlice, std::vector<T> buffer) {
+    void Raster::write(const Slice &outSlice, const std::vector<T> &buffer) {
         Slice slice = outSlice;
         
-        // size of the slice of data is the SAME as the size of the slice in the file:
-        hsize_t memdims[2];
-        memdims[0]=slice.getDeltaY();
-        memdims[1]=slice.getDeltaX();
+        long int totalSize = slice.getCountX() * slice.getCountY();
+        if ((long int)buffer.size() < totalSize) throw_SliceSizeError(fullRastername);
+        if (totalSize <= 0) return;
+        
+        write(outSlice, &buffer[0]);
+    }
+    
+    
+    template<typename T>
+    void Raster::write(const Slice &outSlice, const T *buffer, const long int &stride) {
+        Slice slice = outSlice;
+        if (stride < 1) throw_RasterWriteError(fullRastername + " invalid buffer stride " + std::to_string(stride));
         
-        H5::DataSpace memspace(2,memdims);
+        // the slice in memory is just the countX*countY selected pixels, stride elements apart:
+        hsize_t totalSize = slice.getCountX() * slice.getCountY();
+        if (totalSize == 0) return;
+        H5::DataSpace memspace = stridedMemspace(totalSize, stride);
         
         H5::DataSpace dataspace = rasterobj->getSpace();
         
-        // set the slice within the file's dataset we want to write to:
+        // set the slice within the file's dataset we want to write to; the slice's strideX/strideY
+        //  select every strideX'th pixel/strideY'th row, so HDF5 only touches the decimated pixels:
         hsize_t count[2];
         hsize_t start[2];
+        hsize_t fileStride[2];
         start[0]=slice.getY0();
         start[1]=slice.getX0();
-        count[0]=slice.getDeltaY();
-        count[1]=slice.getDeltaX();
-        dataspace.selectHyperslab(H5S_SELECT_SET, count, start);
-        
-        //int totalSize = (count[0] - start[0]) * (count[1] - start[1]);
-        int totalSize = count[0] * count[1];
-        if (buffer.size() < totalSize) throw_SliceSizeError(fullRastername);
+        count[0]=slice.getCountY();
+        count[1]=slice.getCountX();
+        fileStride[0]=std::max(1L, slice.getStrideY());
+        fileStride[1]=std::max(1L, slice.getStrideX());
+        selectWindow(dataspace, H5S_SELECT_SET, start, count, fileStride);
         
         H5::PredType h5Type = Raster::getHdf5Type<T>();
         
+        // tiles of this window cached for readers are out of date:
+        SharedTileCache::instance().invalidate(fullRastername, slice.getX0(), slice.getY0(),
+                                               slice.getDeltaX(), slice.getDeltaY());
         try {
-            rasterobj->write( (void *)&buffer[0], h5Type, memspace, dataspace );
+            rasterobj->write( (const void *)buffer, h5Type, memspace, dataspace );
         } catch (H5::DataSetIException e) {
             throw_RasterWriteError(fullRastername + " " + e.getDetailMsg());
         }
-    }
+    } // end: write
     
     
     template<typename T>
     void Raster::read(const Slice &inSlice, std::vector<T> &buffer) const {
         Slice slice = inSlice;
         
-        // size of the slice of data is the SAME as the size of the slice in the file:
-        hsize_t memdims[2];
-        memdims[0]=slice.getDeltaY();
-        memdims[1]=slice.getDeltaX();
-        H5::DataSpace memspace(2,memdims);
+        long int totalSize = slice.getCountX() * slice.getCountY();
+        if ((long int)buffer.size() < totalSize) buffer.resize(totalSize);
+        if (totalSize <= 0) return;
+        
+        read(inSlice, &buffer[0]);
+    }
+    
+    
+    template<typename T>
+    void Raster::read(const Slice &inSlice, T *buffer, const long int &stride) const {
+        Slice slice = inSlice;
+        if (stride < 1) throw_RasterReadError(fullRastername + " invalid buffer stride " + std::to_string(stride));
+        
+        // the slice in memory is just the countX*countY selected pixels, stride elements apart:
+        hsize_t totalSize = slice.getCountX() * slice.getCountY();
+        if (totalSize == 0) return;
+        H5::DataSpace memspace = stridedMemspace(totalSize, stride);
         
         H5::DataSpace dataspace = rasterobj->getSpace();
         
-        // set the slice within the file's dataset we want to read from:
-        // we want an offset of (50,50), and a size of 100X100
+        // set the slice within the file's dataset we want to read from; the slice's strideX/strideY
+        //  select every strideX'th pixel/strideY'th row, so HDF5 only touches the decimated pixels:
         hsize_t count[2];
         hsize_t start[2];
+        hsize_t fileStride[2];
         start[0]=slice.getY0();
         start[1]=slice.getX0();
-        count[0]=slice.getDeltaY();
-        count[1]=slice.getDeltaX();
-        dataspace.selectHyperslab(H5S_SELECT_SET, count, start);
-        
-        //int totalSize = (count[0] - start[0]) * (count[1] - start[1]);
-        int totalSize = count[0] * count[1];
-        if (buffer.size() < totalSize) buffer.resize(totalSize);
+        count[0]=slice.getCountY();
+        count[1]=slice.getCountX();
+        fileStride[0]=std::max(1L, slice.getStrideY());
+        fileStride[1]=std::max(1L, slice.getStrideX());
+        selectWindow(dataspace, H5S_SELECT_SET, start, count, fileStride);
         
         H5::PredType h5Type = Raster::getHdf5Type<T>();
         
         try {
-            rasterobj->read( (void *)&buffer[0], h5Type, memspace, dataspace );
+            rasterobj->read( (void *)buffer, h5Type, memspace, dataspace );
         } catch (H5::DataSetIException e) {
             throw_RasterReadError(fullRastername + " " + e.getDetailMsg());
         }
     } // end: read
+    
+    
+    template<typename T>
+    void Raster::readMany(const std::vector<Slice> &slices, std::vector<std::vector<T> > &buffers) const {
+        buffers.resize(slices.size());
+        
+        // every row of every (dense) slice is a run [x0,x1) of pixels in row y; strided slices
+        //  are simply read on their own.
+        struct Run {
+            long int y, x0, x1;
+            hsize_t offset;      // position of the run's first pixel in the union's read order
+            bool operator<(const Run &other) const {
+                return (y < other.y) || (y == other.y && x0 < other.x0);
+            }
+        };
+        std::vector<Run> runs;
+        std::vector<size_t> dense;
+        for (size_t i = 0; i < slices.size(); i++) {
+            const Slice &slice = slices[i];
+            if (slice.getStrideX() > 1 || slice.getStrideY() > 1) {
+                read(slice, buffers[i]);
+                continue;
+            }
+            buffers[i].resize(slice.getDeltaX() * slice.getDeltaY());
+            if (slice.getDeltaX() <= 0 || slice.getDeltaY() <= 0) continue;
+            dense.push_back(i);
+            for (long int y = slice.getY0(); y < slice.getY0() + slice.getDeltaY(); y++) {
+                Run run = {y, slice.getX0(), slice.getX0() + slice.getDeltaX(), 0};
+                runs.push_back(run);
+            }
+        }// endfor
+        if (dense.empty()) return;
+        
+        // merge overlapping/touching runs: HDF5 delivers the union in row-major order, so the
+        //  merged runs, sorted, tell where each pixel lands in the read buffer.
+        std::sort(runs.begin(), runs.end());
+        std::vector<Run> merged;
+        for (size_t r = 0; r < runs.size(); r++) {
+            if (!merged.empty() && merged.back().y == runs[r].y && runs[r].x0 <= merged.back().x1) {
+                merged.back().x1 = std::max(merged.back().x1, runs[r].x1);
+            } else {
+                merged.push_back(runs[r]);
+            }
+        }// endfor
+        hsize_t total = 0;
+        for (size_t r = 0; r < merged.size(); r++) {
+            merged[r].offset = total;
+            total += merged[r].x1 - merged[r].x0;
+        }// endfor
+        
+        // the union of the slices, in the file:
+        H5::DataSpace dataspace = rasterobj->getSpace();
+        for (size_t k = 0; k < dense.size(); k++) {
+            const Slice &slice = slices[dense[k]];
+            hsize_t count[2];
+            hsize_t start[2];
+            start[0]=slice.getY0();
+            start[1]=slice.getX0();
+            count[0]=slice.getDeltaY();
+            count[1]=slice.getDeltaX();
+            hsize_t unitStride[2] = {1, 1};
+            selectWindow(dataspace, (k == 0) ? H5S_SELECT_SET : H5S_SELECT_OR, start, count, unitStride);
+        }// endfor
+        if (!dataspace.selectValid() || (hsize_t)dataspace.getSelectNpoints() != total)
+            throw_RasterReadError(fullRastername + " readMany: slice outside of the raster");
+        
+        std::vector<T> all(total);
+        H5::DataSpace memspace = stridedMemspace(total, 1);
+        H5::PredType h5Type = Raster::getHdf5Type<T>();
+        try {
+            rasterobj->read( (void *)&all[0], h5Type, memspace, dataspace );
+        } catch (const H5::DataSetIException &e) {
+            throw_RasterReadError(fullRastername + " " + e.getDetailMsg());
+        }
+        
+        // scatter: each row of a slice lies inside one merged run.
+        for (size_t k = 0; k < dense.size(); k++) {
+            const Slice &slice = slices[dense[k]];
+            std::vector<T> &buffer = buffers[dense[k]];
+            long int dx = slice.getDeltaX();
+            for (long int j = 0; j < slice.getDeltaY(); j++) {
+                Run key = {slice.getY0() + j, slice.getX0(), 0, 0};
+                // the last merged run starting at or before (y, x0):
+                typename std::vector<Run>::const_iterator it = std::upper_bound(merged.begin(), merged.end(), key);
+                --it;
+                std::copy(all.begin() + it->offset + (slice.getX0() - it->x0),
+                          all.begin() + it->offset + (slice.getX0() - it->x0) + dx,
+                          buffer.begin() + j*dx);
+            }// endfor
+        }// endfor
+    } // end: readMany
+    
+    
+    // memory dataspace for n pixels, that are 'stride' elements apart in the caller's buffer.
+    // The extent stops at the last pixel, so a buffer offset into an interleaved array
+    //  (e.g. &complexData[0][1], stride 2) is never addressed past its end.
+    H5::DataSpace Raster::stridedMemspace(const hsize_t &n, const long int &stride) const {
+        hsize_t memdims[1];
+        memdims[0] = (n-1)*stride + 1;
+        H5::DataSpace memspace(1,memdims);
+        if (stride > 1) {
+            hsize_t start[1] = {0};
+            hsize_t count[1] = {n};
+            hsize_t memStride[1];
+            memStride[0] = stride;
+            memspace.selectHyperslab(H5S_SELECT_SET, count, start, memStride);
+        }
+        return memspace;
+    }
+
+
+
+    size_t Raster::chunkGeometry(long int &chunksX, long int &chunksY) const {
+        chunksX = 0;
+        chunksY = 0;
+        long int chunkX, chunkY;
+        if (!chunkSize(chunkX, chunkY)) return 0;
+
+        long int nx = get_nx();
+        long int ny = get_ny();
+        chunksX = std::max(1L, (nx + chunkX - 1) / chunkX);
+        chunksY = std::max(1L, (ny + chunkY - 1) / chunkY);
+
+        // the cache holds chunks uncompressed, in the dataset's (full-width) type; a band-stack
+        //  chunk holds every band:
+        size_t chunkBytes = chunkX * chunkY * rasterobj->getDataType().getSize();
+        if (band >= 0) {
+            hsize_t chunk_dims[3];
+            rasterobj->getCreatePlist().getChunk(3, chunk_dims);
+            chunkBytes *= chunk_dims[bandLast ? 2 : 0];
+        }
+        return chunkBytes;
+    }// end: chunkGeometry
+
+
+    ChunkCache Raster::rowScanCache() const {
+        long int chunksX, chunksY;
+        size_t chunkBytes = chunkGeometry(chunksX, chunksY);
+        if (chunkBytes == 0) return getChunkCache();
+        // a row of pixels touches every chunk in a row of chunks, and all of them are touched again
+        //  by the next row; once a row of chunks is done it is never used again.  Two rows of
+        //  chunks, so 2x2 interpolation neighborhoods that straddle a chunk boundary stay cached.
+        return ChunkCache::forChunks(2*chunksX, chunkBytes, 1.0);
+    }// end: rowScanCache
+
+
+    ChunkCache Raster::columnScanCache() const {
+        long int chunksX, chunksY;
+        size_t chunkBytes = chunkGeometry(chunksX, chunksY);
+        if (chunkBytes == 0) return getChunkCache();
+        // a column touches every chunk in a column of chunks, each only partly; keep them all
+        //  for the next column instead of evicting the ones just touched.
+        return ChunkCache::forChunks(chunksY, chunkBytes, 0.0);
+    }// end: columnScanCache
+
+
+    ChunkCache Raster::windowCache() const {
+        long int chunksX, chunksY;
+        size_t chunkBytes = chunkGeometry(chunksX, chunksY);
+        if (chunkBytes == 0) return getChunkCache();
+        // small windows all over the raster: keep as many chunks as allowed.
+        return ChunkCache::forChunks(chunksX*chunksY, chunkBytes, 0.75);
+    }// end: windowCache
+
+
+    ChunkCache Raster::tuneChunkCache(const ChunkCache &cache) const {
+        ChunkCache old = getChunkCache();
+        if (cache != old) setChunkCache(cache);
+        return old;
+    }// end: tuneChunkCache
+
+
+    ChunkCache Raster::getChunkCache() const {
+        size_t rdcc_nslots, rdcc_nbytes;
+        double rdcc_w0;
+        // the access plist of an open dataset holds the cache settings in use, including
+        //  those inherited from the file.
+        rasterobj->getAccessPlist().getChunkCache(rdcc_nslots, rdcc_nbytes, rdcc_w0);
+        return ChunkCache(rdcc_nbytes, rdcc_nslots, rdcc_w0);
+    }// end: getChunkCache
+
+
+    void Raster::setChunkCache(const ChunkCache &cache) const {
+        long int chunksX, chunksY;
+        size_t chunkBytes = chunkGeometry(chunksX, chunksY);
+        if (chunkBytes == 0) return;
+
+        // HDF5 only reads the cache settings when the dataset is opened, and not when another
+        //  handle already holds it open (the new handle shares that one's cache), so this handle
+        //  is closed first.  If the open fails, the dataset is opened again as it was, so this
+        //  Raster is never left with a closed dataset.
+        H5::DSetAccPropList dapl = cache.dsetAccPropList(chunkBytes);
+        H5::DSetAccPropList oldDapl = rasterobj->getAccessPlist();
+        rasterobj->close();
+        try {
+            *rasterobj = image->openDataset(rastername, dapl);
+        } catch (const H5::Exception &e) {
+            try {
+                *rasterobj = image->openDataset(rastername, oldDapl);
+            } catch (...) {
+            }
+            throw_RasterOpenError(fullRastername+"  "+e.getDetailMsg());
+        }
+    }// end: setChunkCache
 
 
     
     void Raster::copy(Raster *rasNew) {
-        switch(raster_datatype) {
-            case INT8U:
-                copyType<uint8_t>(rasNew);
-                break;
-            /*
-             case INT8S:
-             copyType<int8_t>(rasNew);
-             case INT16U:
-             copyType<uint16_t>(rasNew);
-             case INT16S:
-             copyType<int16_t>(rasNew);
-             case INT32U:
-             copyType<uint32_t>(rasNew);
-             case INT32S:
-             copyType<int32_t>(rasNew);
-             case INT64U:
-             copyType<uint64_t>(rasNew);
-             case INT64S:
-             copyType<int64_t>(rasNew);
-             */
-            case REAL32:
-                copyType<float>(rasNew);
-                break;
-            case REAL64:
-                copyType<double>(rasNew);
-                break;
-            //case COMPLEX_INT16:
-            //    return
-            default:
-            throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        if (copyChunks(rasNew)) return;
+        visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            copyType<T>(rasNew);
+        }, fullRastername);
         return;
     }
     
     
     
+    bool Raster::copyChunks(Raster *rasNew) const {
+        if (band >= 0 || rasNew->band >= 0) return false;
+        if (get_nx() != rasNew->get_nx() || get_ny() != rasNew->get_ny()) return false;
+        if (!(rasterobj->getDataType() == rasNew->rasterobj->getDataType())) return false;
+
+        H5::DSetCreatPropList inParms = rasterobj->getCreatePlist();
+        H5::DSetCreatPropList outParms = rasNew->rasterobj->getCreatePlist();
+        if (inParms.getLayout() != H5D_CHUNKED || outParms.getLayout() != H5D_CHUNKED) return false;
+        hsize_t inChunk[2], outChunk[2];
+        inParms.getChunk(2, inChunk);
+        outParms.getChunk(2, outChunk);
+        if (inChunk[0] != outChunk[0] || inChunk[1] != outChunk[1]) return false;
+
+        // the same filters, with the same settings, so the stored bytes mean the same in both:
+        int nfilters = inParms.getNfilters();
+        if (nfilters != outParms.getNfilters()) return false;
+        for (int k = 0; k < nfilters; k++) {
+            unsigned int inFlags, outFlags;
+            unsigned int inValues[8], outValues[8];
+            size_t inN = 8, outN = 8;
+            H5Z_filter_t inId = H5Pget_filter2(inParms.getId(), k, &inFlags, &inN, inValues, 0, NULL, NULL);
+            H5Z_filter_t outId = H5Pget_filter2(outParms.getId(), k, &outFlags, &outN, outValues, 0, NULL, NULL);
+            if (inId != outId || inN != outN) return false;
+            for (size_t v = 0; v < inN && v < 8; v++)
+                if (inValues[v] != outValues[v]) return false;
+        }// endfor: k
+
+        // chunks that this raster never wrote are skipped, so they must read the same in rasNew:
+        if (!rasNew->isBlankFill(getFillValue())) return false;
+
+        SharedTileCache::instance().invalidate(rasNew->fullRastername);
+        hid_t inId = rasterobj->getId();
+        hid_t outId = rasNew->rasterobj->getId();
+        hsize_t nChunks = 0;
+        if (H5Dget_num_chunks(inId, H5S_ALL, &nChunks) < 0) return false;
+
+        std::vector<unsigned char> buffer;
+        for (hsize_t k = 0; k < nChunks; k++) {
+            hsize_t offset[2];
+            unsigned int filterMask;
+            haddr_t addr;
+            hsize_t size;
+            if (H5Dget_chunk_info(inId, H5S_ALL, k, offset, &filterMask, &addr, &size) < 0)
+                throw_RasterReadError(fullRastername + " copy: chunk " + std::to_string(k));
+            buffer.resize(size);
+            if (H5Dread_chunk(inId, H5P_DEFAULT, offset, &filterMask, &buffer[0]) < 0)
+                throw_RasterReadError(fullRastername + " copy: chunk " + std::to_string(k));
+            if (H5Dwrite_chunk(outId, H5P_DEFAULT, filterMask, offset, size, &buffer[0]) < 0)
+                throw_RasterWriteError(rasNew->fullRastername + " copy: chunk " + std::to_string(k));
+        }// endfor: k
+        return true;
+    }// end: copyChunks
+
+
+
     template <typename T>
     void Raster::copyType(Raster *outRaster) {
         
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        GeoStar::Slice tileDescriptor(0,0,8,8);
-        int maxNumberSlicesInRam = 70;
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
+        // one output row at a time: tiles sized to the input's chunks, enough of them for a row sweep
+        GeoStar::TileIO<T> reader(this, get_nx(), 2);
+
+        // chunk caches for this access pattern (restored at the end):
+        ChunkCacheGuard inCache(this, rowScanCache());
+        ChunkCacheGuard outCache(outRaster, outRaster->rowScanCache());
         
         GeoStar::Slice scalingSlice(0,0,2,2,4);
         
@@ -482,13 +995,16 @@ namespace GeoStar {
                  return zeroPixel;
              }
          }
-         std::vector<T> data = reader.tileRead(scalingSlice);
+         // at most 2x2 pixels, straight from the cached tile(s):
+         T data[4];
          int deltaX = scalingSlice.getDeltaX();
+         reader.neighborhood(scalingSlice.getX0(), scalingSlice.getY0(), deltaX, scalingSlice.getDeltaY(), data);
      
+         // interpolate in double: negating a wide unsigned pixel would wrap around
          T pixelValX1, pixelValX2, pixelVal;
-         pixelValX1 = ((-data[m*deltaX + n] + data[m1*deltaX + n]) * xDiff) + data[m*deltaX + n];
-         pixelValX2 = ((-data[m*deltaX + n1] + data[m1*deltaX + n1]) * xDiff) + data[m*deltaX + n1];
-         pixelVal = ((-pixelValX1 + pixelValX2) * yDiff) + pixelValX1;
+         pixelValX1 = (T)(((-(double)data[m*deltaX + n] + data[m1*deltaX + n]) * xDiff) + data[m*deltaX + n]);
+         pixelValX2 = (T)(((-(double)data[m*deltaX + n1] + data[m1*deltaX + n1]) * xDiff) + data[m*deltaX + n1]);
+         pixelVal = (T)(((-(double)pixelValX1 + pixelValX2) * yDiff) + pixelValX1);
          return pixelVal;
      }
     
@@ -667,6 +1183,18 @@ namespace GeoStar {
         else if (type == H5::PredType::NATIVE_INT64) return INT64S;
         else if (type == H5::PredType::NATIVE_FLOAT) return REAL32;
         else if (type == H5::PredType::NATIVE_DOUBLE) return REAL64;
+        else if (type.getClass() == H5T_INTEGER) {
+            // integer rasters stored with the n-bit filter have a reduced-precision type
+            //  (see RasterLayout::storageType); match them on size and sign:
+            bool isSigned = (H5Tget_sign(type.getId()) != H5T_SGN_NONE);
+            switch (type.getSize()) {
+                case 1: return isSigned ? INT8S : INT8U;
+                case 2: return isSigned ? INT16S : INT16U;
+                case 4: return isSigned ? INT32S : INT32U;
+                case 8: return isSigned ? INT64S : INT64U;
+                default: throw_Hdf5UnsupportedTypeError(fullRastername);
+            }
+        }
         else throw_Hdf5UnsupportedTypeError(fullRastername);
     }
     
@@ -691,19 +1219,91 @@ namespace GeoStar {
 
     // NOTE: user does NOT need to call write<'type'>(...); merely call write(...) and type will be inferred
     //    from the vector parameter type:
-    template void Raster::write<uint8_t>(const Slice &, std::vector<uint8_t>);
-    template void Raster::write<float>(const Slice &, std::vector<float>);
-    template void Raster::write<double>(const Slice &, std::vector<double>);
+    template void Raster::write<uint8_t>(const Slice &, const std::vector<uint8_t>&);
+    template void Raster::write<int8_t>(const Slice &, const std::vector<int8_t>&);
+    template void Raster::write<uint16_t>(const Slice &, const std::vector<uint16_t>&);
+    template void Raster::write<int16_t>(const Slice &, const std::vector<int16_t>&);
+    template void Raster::write<uint32_t>(const Slice &, const std::vector<uint32_t>&);
+    template void Raster::write<int32_t>(const Slice &, const std::vector<int32_t>&);
+    template void Raster::write<uint64_t>(const Slice &, const std::vector<uint64_t>&);
+    template void Raster::write<int64_t>(const Slice &, const std::vector<int64_t>&);
+    template void Raster::write<float>(const Slice &, const std::vector<float>&);
+    template void Raster::write<double>(const Slice &, const std::vector<double>&);
+
+    template void Raster::write<uint8_t>(const Slice &, const uint8_t*, const long int&);
+    template void Raster::write<int8_t>(const Slice &, const int8_t*, const long int&);
+    template void Raster::write<uint16_t>(const Slice &, const uint16_t*, const long int&);
+    template void Raster::write<int16_t>(const Slice &, const int16_t*, const long int&);
+    template void Raster::write<uint32_t>(const Slice &, const uint32_t*, const long int&);
+    template void Raster::write<int32_t>(const Slice &, const int32_t*, const long int&);
+    template void Raster::write<uint64_t>(const Slice &, const uint64_t*, const long int&);
+    template void Raster::write<int64_t>(const Slice &, const int64_t*, const long int&);
+    template void Raster::write<float>(const Slice &, const float*, const long int&);
+    template void Raster::write<double>(const Slice &, const double*, const long int&);
 
     template void Raster::read<uint8_t>(const Slice &, std::vector<uint8_t>&)const;
+    template void Raster::read<int8_t>(const Slice &, std::vector<int8_t>&)const;
+    template void Raster::read<uint16_t>(const Slice &, std::vector<uint16_t>&)const;
+    template void Raster::read<int16_t>(const Slice &, std::vector<int16_t>&)const;
+    template void Raster::read<uint32_t>(const Slice &, std::vector<uint32_t>&)const;
+    template void Raster::read<int32_t>(const Slice &, std::vector<int32_t>&)const;
+    template void Raster::read<uint64_t>(const Slice &, std::vector<uint64_t>&)const;
+    template void Raster::read<int64_t>(const Slice &, std::vector<int64_t>&)const;
     template void Raster::read<float>(const Slice &, std::vector<float>&)const;
     template void Raster::read<double>(const Slice &, std::vector<double>&)const;
+
+    template void Raster::read<uint8_t>(const Slice &, uint8_t*, const long int&)const;
+    template void Raster::read<int8_t>(const Slice &, int8_t*, const long int&)const;
+    template void Raster::read<uint16_t>(const Slice &, uint16_t*, const long int&)const;
+    template void Raster::read<int16_t>(const Slice &, int16_t*, const long int&)const;
+    template void Raster::read<uint32_t>(const Slice &, uint32_t*, const long int&)const;
+    template void Raster::read<int32_t>(const Slice &, int32_t*, const long int&)const;
+    template void Raster::read<uint64_t>(const Slice &, uint64_t*, const long int&)const;
+    template void Raster::read<int64_t>(const Slice &, int64_t*, const long int&)const;
+    template void Raster::read<float>(const Slice &, float*, const long int&)const;
+    template void Raster::read<double>(const Slice &, double*, const long int&)const;
+
+    template void Raster::readMany<uint8_t>(const std::vector<Slice> &, std::vector<std::vector<uint8_t> >&)const;
+    template void Raster::readMany<int8_t>(const std::vector<Slice> &, std::vector<std::vector<int8_t> >&)const;
+    template void Raster::readMany<uint16_t>(const std::vector<Slice> &, std::vector<std::vector<uint16_t> >&)const;
+    template void Raster::readMany<int16_t>(const std::vector<Slice> &, std::vector<std::vector<int16_t> >&)const;
+    template void Raster::readMany<uint32_t>(const std::vector<Slice> &, std::vector<std::vector<uint32_t> >&)const;
+    template void Raster::readMany<int32_t>(const std::vector<Slice> &, std::vector<std::vector<int32_t> >&)const;
+    template void Raster::readMany<uint64_t>(const std::vector<Slice> &, std::vector<std::vector<uint64_t> >&)const;
+    template void Raster::readMany<int64_t>(const std::vector<Slice> &, std::vector<std::vector<int64_t> >&)const;
+    template void Raster::readMany<float>(const std::vector<Slice> &, std::vector<std::vector<float> >&)const;
+    template void Raster::readMany<double>(const std::vector<Slice> &, std::vector<std::vector<double> >&)const;
+
+    template void Raster::appendRows<uint8_t>(const std::vector<uint8_t> &, const long int &);
+    template void Raster::appendRows<int8_t>(const std::vector<int8_t> &, const long int &);
+    template void Raster::appendRows<uint16_t>(const std::vector<uint16_t> &, const long int &);
+    template void Raster::appendRows<int16_t>(const std::vector<int16_t> &, const long int &);
+    template void Raster::appendRows<uint32_t>(const std::vector<uint32_t> &, const long int &);
+    template void Raster::appendRows<int32_t>(const std::vector<int32_t> &, const long int &);
+    template void Raster::appendRows<uint64_t>(const std::vector<uint64_t> &, const long int &);
+    template void Raster::appendRows<int64_t>(const std::vector<int64_t> &, const long int &);
+    template void Raster::appendRows<float>(const std::vector<float> &, const long int &);
+    template void Raster::appendRows<double>(const std::vector<double> &, const long int &);
     
     template void Raster::copyType<uint8_t>(Raster*);
+    template void Raster::copyType<int8_t>(Raster*);
+    template void Raster::copyType<uint16_t>(Raster*);
+    template void Raster::copyType<int16_t>(Raster*);
+    template void Raster::copyType<uint32_t>(Raster*);
+    template void Raster::copyType<int32_t>(Raster*);
+    template void Raster::copyType<uint64_t>(Raster*);
+    template void Raster::copyType<int64_t>(Raster*);
     template void Raster::copyType<float>(Raster*);
     template void Raster::copyType<double>(Raster*);
     
     template uint8_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<uint8_t>&);
+    template int8_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<int8_t>&);
+    template uint16_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<uint16_t>&);
+    template int16_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<int16_t>&);
+    template uint32_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<uint32_t>&);
+    template int32_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<int32_t>&);
+    template uint64_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<uint64_t>&);
+    template int64_t Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<int64_t>&);
     template float Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<float>&);
     template double Raster::getScaledPixelFromTile(long int, long int, double, double, Slice&, Slice&, TileIO<double>&);
 
@@ -714,25 +1314,14 @@ namespace GeoStar {
 
 
     void Raster::scale_pixel_values(Raster *ras_out, const double &offset, const double &mult) const {
-    long int nx = get_nx();
-    long int ny = get_ny();
-    int i;
-
-    Slice slice(0,0,nx,1);
-
-    std::vector<float>indata(nx);
-    std::vector<float>outdata(nx);
-
-    for(int line=0;line<ny;++line) {
-      slice.setY0(line);
-      read(slice,indata);
-      for(int pixel=0; pixel<nx;++pixel) {
-        i = mult*(indata[pixel]-offset);
+    forEachBlock<float>(ras_out, [&](const Slice &, std::vector<float> &data) {
+      int i;
+      for(size_t pixel=0; pixel<data.size();++pixel) {
+        i = mult*(data[pixel]-offset);
         if (i<0)   i=0;
-        outdata[pixel]= i;
+        data[pixel]= i;
       }// endfor: pixel
-      ras_out->write(slice, outdata);
-    }// endfor: line
+    });
 
   }// end: scale_pixel_values
 
@@ -773,8 +1362,19 @@ namespace GeoStar {
 
 
 
+  template <typename T>
+  T Raster::pixelColor(const double &color) {
+    double value = std::numeric_limits<T>::is_integer ? std::round(color) : color;
+    if (std::isnan(value)) return std::numeric_limits<T>::is_integer ? T(0) : static_cast<T>(value);
+    // (compared as doubles: the largest 64-bit integers do not convert back exactly)
+    if (value <= (double)std::numeric_limits<T>::lowest()) return std::numeric_limits<T>::lowest();
+    if (value >= (double)std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+    return static_cast<T>(value);
+  }// end: pixelColor
+
+
+
   void Raster::set(const Slice &slice, const int &value) {
-    int i;
 
     long int nx = get_nx();
     long int ny = get_ny();
@@ -782,16 +1382,19 @@ namespace GeoStar {
     //check if input slice fits in raster
     if (nx < (slice.getX0() + slice.getDeltaX()) ) throw_SliceSizeError("set");
     if (ny < (slice.getY0() + slice.getDeltaY()) ) throw_SliceSizeError("set");
-    
-    long int num = slice.getDeltaX()*slice.getDeltaY();
-    std::vector<float>data(num);
-
-    //assume slices are small, do all at one go:
-    for(int i=0;i<num;i++){
-      data[i]=value;
-    }// endfor
 
-    write(slice, data);
+    // whole chunks are written as they are; only the chunks at the edges of slice are merged.
+    //  The whole raster is set as setPixels does, as a fill value when it can be.
+    visitRasterType(raster_datatype, [&](auto tag) {
+        typedef typename decltype(tag)::type T;
+        if (refillable(slice)) {
+            refill(pixelColor<T>(value));
+            return;
+        }
+        TileWriter<T> writer(this);
+        writer.fill(slice, pixelColor<T>(value));
+        writer.flush();
+    }, fullRastername);
 
   }// end: set
 
@@ -804,16 +1407,14 @@ namespace GeoStar {
 	if ((x0 - delta) < 0 || (x0 + delta) > nx) throw_SliceSizeError("drawPoint");
 	if ((y0 - delta) < 0 || (y0 + delta) > ny) throw_SliceSizeError("drawPoint");
 
-        Slice slice(x0-delta, y0-delta, x0+delta, y0+delta);
-
-	long int size = 4.*delta*delta;
-	std::vector<float>data(size);
-	
-	for(int i = 0; i < size; i++) {
-	data[i] = color;
-	}
+        Slice slice(x0-delta, y0-delta, 2*delta, 2*delta);
 
-	write(slice, data);
+	visitRasterType(raster_datatype, [&](auto tag) {
+	    typedef typename decltype(tag)::type T;
+	    TileWriter<T> writer(this);
+	    writer.fill(slice, pixelColor<T>(color));
+	    writer.flush();
+	}, fullRastername);
 
  }//end drawPoint
 
@@ -831,40 +1432,31 @@ namespace GeoStar {
 	if ((slice_x0 + slice_dx - radius) < 0 || (slice_x0 + slice_dx + radius) > nx) throw_RasterSizeError("in drawLine");
 	if ((slice_y0 + slice_dy - radius) < 0 || (slice_y0 + slice_dy + radius) > ny) throw_RasterSizeError("in drawLine");
 
-	std::vector<float> data;
-	read(slice, data);
-
-	drawFilledCircle(slice_x0, slice_y0, radius, color);
-
-	drawFilledCircle(slice_x0 + slice_dx, slice_y0 + slice_dy, radius, color);
-
-	double slope = slice_dy / slice_dx;
-	double y = 0;
-
-	double distDivisor = sqrt((slice_dx * slice_dx) + (slice_dy * slice_dy));
-	double lineDist = 0;
-
-	//define equation of line as y-y1 = slope(x-x1)
-	// -> y = slope*x - slope*x1 + y1
-	// but within the slice, x1 and y1 are zero (initial points) so y = slope * x
-	for (int i = 0; i < slice_dx; ++i) {
-	  y = (slope * i);
-	  data[y * slice_dy + i] = color;
-	}
-
-	//now sweep through slice and find any points with distance to line less than the radius
-	//use (Ax + By + C) / sqrt(A^2 + B^2) for the distance calculation
+	//the line runs from (slice_x0, slice_y0) to (slice_x0+slice_dx, slice_y0+slice_dy); light up
+	// every pixel within radius of it (which rounds the ends, as the circles drawn there did).
+	//distance to the segment: project onto it, clamp to the ends, and measure from there.
+	long int xMin = std::max(0L, (long int)floor(std::min(slice_x0, slice_x0 + slice_dx) - radius));
+	long int xMax = std::min(nx - 1, (long int)ceil(std::max(slice_x0, slice_x0 + slice_dx) + radius));
+	long int yMin = std::max(0L, (long int)floor(std::min(slice_y0, slice_y0 + slice_dy) - radius));
+	long int yMax = std::min(ny - 1, (long int)ceil(std::max(slice_y0, slice_y0 + slice_dy) + radius));
+	double lengthsq = (double)slice_dx * slice_dx + (double)slice_dy * slice_dy;
+	double rsq = radius * radius;
 
-	for (int i = 0; i < slice_dy; ++i) {
-	  for (int j = 0; j < slice_dx; ++j) {
-	    lineDist = fabs((slice_dx * i) - (slice_dy * j)) / distDivisor;
-	    if (lineDist <= radius) {
-		data[i * slice_dy + j] = color;
-		}//endif
+	visitRasterType(raster_datatype, [&](auto tag) {
+	  typedef typename decltype(tag)::type T;
+	  TileWriter<T> writer(this);
+	  T value = pixelColor<T>(color);
+	  for (long int y = yMin; y <= yMax; ++y) {
+	    for (long int x = xMin; x <= xMax; ++x) {
+	      double px = x - slice_x0, py = y - slice_y0;
+	      double t = (lengthsq > 0) ? (px * slice_dx + py * slice_dy) / lengthsq : 0;
+	      t = std::max(0.0, std::min(1.0, t));
+	      double dx = px - t * slice_dx, dy = py - t * slice_dy;
+	      if (dx * dx + dy * dy <= rsq) writer.set(x, y, value);
+	    }//endfor
 	  }//endfor
-	}//endfor
-
-	write(slice, data);
+	  writer.flush();
+	}, fullRastername);
 		
  }//end drawLine
 
@@ -876,30 +1468,14 @@ namespace GeoStar {
 	if (slice.getX0() < 0 || slice.getDeltaX() > nx) throw_RasterSizeError("in drawRectangle");
 	if (slice.getY0() < 0 || slice.getDeltaY() > ny) throw_RasterSizeError("in drawRectangle");
 
-	//draw edges of desired radius one at a time, setting each region to desired color
-
-	//left edge
-        Slice oslice=slice;
-        oslice.setDeltaX(radius);
-	set(oslice, color);
-
-	//top edge
-	oslice.setDeltaX(slice.getDeltaX());
-	oslice.setDeltaY(radius);
-	set(oslice, color);
-
-	//bottom edge
-        oslice=slice;
-	oslice.setY0(slice.getY0() + slice.getDeltaY() -radius);
-	oslice.setDeltaY(radius);
-	set(oslice, color);
-
-	//right edge
-        oslice=slice;
-	oslice.setX0(slice.getX0() + slice.getDeltaX() -radius);
-	oslice.setDeltaY(radius);
-	set(oslice, color);
-		
+	//draw edges of desired radius one at a time, setting each region to desired color; the
+	// corners, and the chunks the edges share, are written once, at the end
+	visitRasterType(raster_datatype, [&](auto tag) {
+	  typedef typename decltype(tag)::type T;
+	  TileWriter<T> writer(this);
+	  drawEdges(writer, slice, radius, pixelColor<T>(color));
+	  writer.flush();
+	}, fullRastername);
 
  }//endRectangle
 
@@ -912,33 +1488,44 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	if (slice.getX0() < 0 || slice.getDeltaX() > nx) throw_RasterSizeError("in drawFilledRectangle");
 	if (slice.getY0() < 0 || slice.getDeltaY() > ny) throw_RasterSizeError("in drawFilledRectangle");
 
-	//set whole slice to filled color first
-        Slice oslice = slice;
-	set(oslice, fillColor);
+	//set whole slice to filled color first, then the edges over it
+	visitRasterType(raster_datatype, [&](auto tag) {
+	  typedef typename decltype(tag)::type T;
+	  TileWriter<T> writer(this);
+	  writer.fill(slice, pixelColor<T>(fillColor));
+	  drawEdges(writer, slice, radius, pixelColor<T>(lineColor));
+	  writer.flush();
+	}, fullRastername);
+
+ }//endFilledRectangle
+
+
+  template <typename T>
+  void Raster::drawEdges(TileWriter<T> &writer, const Slice &slice, const int radius, const T &color) {
 
-	//draw edges of desired radius one at a time, setting each region to desired color
 	//left edge
+        Slice oslice=slice;
         oslice.setDeltaX(radius);
-	set(oslice, lineColor);
+	writer.fill(oslice, color);
 
 	//top edge
 	oslice.setDeltaX(slice.getDeltaX());
 	oslice.setDeltaY(radius);
-	set(oslice, lineColor);
+	writer.fill(oslice, color);
 
 	//bottom edge
         oslice=slice;
 	oslice.setY0(slice.getY0() + slice.getDeltaY() -radius);
 	oslice.setDeltaY(radius);
-	set(oslice, lineColor);
+	writer.fill(oslice, color);
 
 	//right edge
         oslice=slice;
 	oslice.setX0(slice.getX0() + slice.getDeltaX() -radius);
-	oslice.setDeltaY(radius);
-	set(oslice, lineColor);
+	oslice.setDeltaX(radius);
+	writer.fill(oslice, color);
 
- }//endFilledRectangle
+ }//end drawEdges
 
 
  void Raster::drawFilledCircle(long int x0, long int y0, const double radius, const double color) {
@@ -950,30 +1537,25 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	if ((x0 - radius) < 0 || (x0 + radius) > nx) throw_RasterSizeError("in drawFilledCircle");
 	if ((y0 - radius) < 0 || (y0 + radius) > ny) throw_RasterSizeError("in drawFilledCircle");
 
-	//slice enclosing circle
-        Slice slice(x0-radius, y0-radius, 2*radius, 2*radius);
-
-	long int size = 4.*radius*radius;
-	std::vector<float>data(size);
-	
-	read(slice, data);
-
-	//overwrite pixels within the circle
-	double dx = 0, dy = 0;
-	double distsq = 0;
+	//only the pixels within the circle are set; the rest of its bounding box is not rewritten
+	long int size = 2*radius;
+	long int xStart = x0 - radius;
+	long int yStart = y0 - radius;
 	double rsq = radius * radius;
-	for (int x = 0; x < 2*radius; ++x) {
-	  for (int y = 0; y < 2*radius; ++y) {
-	    dx = x - radius;
-	    dy = y - radius;
-	    distsq = dx * dx + dy * dy;
-	     if (distsq <= rsq) {
-               data[y * slice.getDeltaX() + x] = color;
-	      }//endif
-	   }//endfor
-	}//endfor
 
-	write(slice, data);
+	visitRasterType(raster_datatype, [&](auto tag) {
+	  typedef typename decltype(tag)::type T;
+	  TileWriter<T> writer(this);
+	  T value = pixelColor<T>(color);
+	  for (long int y = 0; y < size; ++y) {
+	    double dy = y - radius;
+	    for (long int x = 0; x < size; ++x) {
+	      double dx = x - radius;
+	      if (dx * dx + dy * dy <= rsq) writer.set(xStart + x, yStart + y, value);
+	    }//endfor
+	  }//endfor
+	  writer.flush();
+	}, fullRastername);
 
  }//end drawFilledCircle
 
@@ -981,9 +1563,8 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 
   GeoStar::Raster * Raster::operator+(const GeoStar::Raster & r2)
   {
-    GeoStar::Image * img = Raster::getParent();
     std::string str = rastername + "_PLUS_" + r2.rastername;
-    GeoStar::Raster * result = new GeoStar::Raster(img, str, raster_datatype, get_nx(), get_ny());
+    GeoStar::Raster * result = image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     this->add(&r2, result);
     return result;
   }
@@ -991,24 +1572,16 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   {
     long int nx = get_nx(), ny = get_ny();
     if(nx != r2->get_nx() || ny != r2->get_ny())throw_RasterSizeError("in add");
-    Slice slice(0,0,nx,1);
-    std::vector<float> bufferA(nx);
-    std::vector<float> bufferB(nx);
-    for(long int i = 0; i < ny; i++)
+    forEachBlock<float>(r2, ras_out, [](const Slice &, std::vector<float> &bufferA, const std::vector<float> &bufferB)
     {
-      slice.setY0(i);
-      read(slice, bufferA);
-      r2->read(slice, bufferB);
-      for(int j = 0; j < get_nx(); j++)bufferA[j] += bufferB[j];
-      ras_out->write(slice, bufferA);
-    }
+      for(size_t j = 0; j < bufferA.size(); j++)bufferA[j] += bufferB[j];
+    });
   }
 
   GeoStar::Raster * Raster::operator-(const GeoStar::Raster & r2)
   {
-    GeoStar::Image * img = Raster::getParent();
     std::string str = rastername + "_MINUS_" + r2.rastername;
-    GeoStar::Raster * result= new GeoStar::Raster(img, str, raster_datatype, get_nx(), get_ny());
+    GeoStar::Raster * result= image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     this->subtract(&r2, result);
     return result;
   }
@@ -1016,24 +1589,16 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   {
     long int nx = get_nx(), ny = get_ny();
     if(nx != r2->get_nx() || ny != r2->get_ny())throw_RasterSizeError("in subtract");
-    Slice slice(0,0,nx,1);
-    std::vector<float> bufferA(nx);
-    std::vector<float> bufferB(nx);
-    for(long int i = 0; i < ny; i++)
+    forEachBlock<float>(r2, ras_out, [](const Slice &, std::vector<float> &bufferA, const std::vector<float> &bufferB)
     {
-      slice.setY0(i);
-      read(slice, bufferA);
-      r2->read(slice, bufferB);
-      for(int j = 0; j < get_nx(); j++)bufferA[j] -= bufferB[j];
-      ras_out->write(slice, bufferA);
-    }
+      for(size_t j = 0; j < bufferA.size(); j++)bufferA[j] -= bufferB[j];
+    });
   }
 
   GeoStar::Raster * Raster::operator*(const GeoStar::Raster & r2)
   {
-    GeoStar::Image * img = Raster::getParent();
     std::string str = rastername + "_TIMES_" + r2.rastername;
-    GeoStar::Raster * result= new GeoStar::Raster(img, str, raster_datatype, get_nx(), get_ny());
+    GeoStar::Raster * result= image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     this->multiply(&r2, result);
     return result;
   }
@@ -1041,25 +1606,17 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   {
     long int nx = get_nx(), ny = get_ny();
     if(nx != r2->get_nx() || ny != r2->get_ny())throw_RasterSizeError("in multiply");
-    Slice slice(0,0,nx,1);
-    std::vector<float> bufferA(nx);
-    std::vector<float> bufferB(nx);
-    for(long int i = 0; i < ny; i++)
+    forEachBlock<float>(r2, ras_out, [](const Slice &, std::vector<float> &bufferA, const std::vector<float> &bufferB)
     {
-      slice.setY0(i);
-      read(slice, bufferA);
-      r2->read(slice, bufferB);
-      for(int j = 0; j < get_nx(); j++)bufferA[j] *= bufferB[j];
-      ras_out->write(slice, bufferA);
-    }
+      for(size_t j = 0; j < bufferA.size(); j++)bufferA[j] *= bufferB[j];
+    });
   }
 
 #ifdef YET
   GeoStar::Raster * Raster::operator/(const GeoStar::Raster & r2)
   {
-    GeoStar::Image * img = Raster::getParent();
     std::string str = rastername + "_DIVIDEDBY_" + r2.rastername;
-    GeoStar::Raster * result= new GeoStar::Raster(img, str, raster_datatype, get_nx(), get_ny());
+    GeoStar::Raster * result= image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     this->divide(r2, result);
     return result;
   }
@@ -1069,21 +1626,14 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   {
     long int nx = get_nx(), ny = get_ny();
     if(nx != r2->get_nx() || ny != r2->get_ny())throw_RasterSizeError("in divide");
-    Slice slice(0,0,nx,1);
-    std::vector<float> bufferA(nx);
-    std::vector<float> bufferB(nx);
-    for(long int i = 0; i < ny; i++)
+    forEachBlock<float>(r2, ras_out, [](const Slice &, std::vector<float> &bufferA, const std::vector<float> &bufferB)
     {
-      slice.setY0(i);
-      read(slice, bufferA);
-      r2->read(slice, bufferB);
-      for(int j = 0; j < get_nx(); j++)
+      for(size_t j = 0; j < bufferA.size(); j++)
       {
         if(bufferB[j] == 0)bufferA[j] = 255; // divide by zero goes to max value
         else bufferA[j] /= bufferB[j];
       }
-      ras_out->write(slice, bufferA);
-    }
+    });
   }
 
   Raster* Raster::resize(Image *img, int resize_width, int resize_height){
@@ -1095,7 +1645,7 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
       return this;
     }
 
-    Raster *ras_temp = img->create_raster("temp", GeoStar::INT8U, resize_width, ny);
+    Raster *ras_temp = img->create_scratch_raster("temp", GeoStar::INT8U, resize_width, ny);
     Raster *ras2 = img->create_raster("resized", GeoStar::INT8U, resize_width, resize_height);
 
 
@@ -1167,9 +1717,8 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 
   GeoStar::Raster * GeoStar::Raster::operator+(const float & val)
   {
-    GeoStar::Image * img = getParent();
     std::string str = rastername+"_PLUS_val";
-    GeoStar::Raster * r2 = new GeoStar::Raster(img, str, raster_datatype, get_nx(),get_ny());
+    GeoStar::Raster * r2 = image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     long int nx = get_nx();
     long int ny = get_ny();
     Slice slice(0,0,nx,1);
@@ -1185,9 +1734,8 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   }
   GeoStar::Raster * GeoStar::Raster::operator-(const float & val)
   {
-    GeoStar::Image * img = getParent();
     std::string str = rastername+"_MINUS_val";
-    GeoStar::Raster * r2 = new GeoStar::Raster(img, str, raster_datatype, get_nx(),get_ny());
+    GeoStar::Raster * r2 = image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     long int nx = get_nx();
     long int ny = get_ny();
     Slice slice(0,0,nx,1);
@@ -1203,9 +1751,8 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   }
   GeoStar::Raster * GeoStar::Raster::operator*(const float & val)
   {
-    GeoStar::Image * img = getParent();
     std::string str = rastername+"_TIMES_val";
-    GeoStar::Raster * r2 = new GeoStar::Raster(img, str, raster_datatype, get_nx(),get_ny());
+    GeoStar::Raster * r2 = image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     long int nx = get_nx();
     long int ny = get_ny();
     Slice slice(0,0,nx,1);
@@ -1221,21 +1768,19 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
   }
   GeoStar::Raster * GeoStar::Raster::operator/(const float & val)
   {
-    GeoStar::Image * img = getParent();
     std::string str = rastername+"_DIVIDEDBY_val";
-    GeoStar::Raster * r2 = new GeoStar::Raster(img, str, raster_datatype, get_nx(),get_ny());
+    GeoStar::Raster * r2 = image->create_scratch_raster(str, raster_datatype, get_nx(), get_ny());
     long int nx = get_nx();
     long int ny = get_ny();
     Slice slice(0,0,nx,1);
     std::vector<float> buffer(nx);
     if(val == 0) // can't divide by zero
     {
-      for(int i = 0; i < nx; i++)buffer[i] = 255; // set to max value
-      for(int i = 0; i < ny; i++)
-      {
-        slice.setY0(i);
-        write(slice, buffer);
-      }
+      // every pixel goes to the max value (255, or less for small types): a fill value, no writes
+      visitRasterType(raster_datatype, [&](auto tag) {
+          typedef typename decltype(tag)::type T;
+          r2->setPixels(static_cast<T>(std::min(255.0, (double)std::numeric_limits<T>::max())));
+      }, fullRastername);
     }
     else
     {
@@ -1315,33 +1860,16 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	if (nx != nx_out) throw_RasterSizeError("in bitShift");
 	if (ny != ny_out) throw_RasterSizeError("in bitShift");
 
-        Slice slice(0,0,nx,1);
-	
-	std::vector<float> data(nx);
-	
-	//loop through image and bitshift right or left, line by line
-	if (direction) {
-          double inverse = 1 / pow(2, bits);
-	  for (int i = 0; i < ny; ++i) {
-            slice.setY0(i);
-            read(slice, data);
-	    for (int j = 0; j < nx; ++j) {
-              data[j] *= inverse;
-	    }//endfor
-	    rasterOut->write(slice, data);
+	//loop through image and bitshift right or left, block by block
+	double factor;
+	if (direction) factor = 1 / pow(2, bits);
+	else factor = pow(2, bits);
+
+	forEachBlock<float>(rasterOut, [&](const Slice &, std::vector<float> &data) {
+	  for (size_t j = 0; j < data.size(); ++j) {
+            data[j] *= factor;
 	  }//endfor
-	}//endif
-	
-	else {
-          for (int i = 0; i < ny; ++i) {
-            slice.setY0(i);
-            read(slice, data);
-            for (int j = 0; j < nx; ++j) {
-              data[j] *= pow(2, bits);
-            }//endfor
-            rasterOut->write(slice, data);
-          }//endfor
-	}//endelse
+	});
         
 
  }//end--bitShift
@@ -1430,30 +1958,27 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	plan = fftw_plan_dft_1d(nx, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
 
 	Slice sliceFFTW(0,0,nx,1);
-	std::vector<double> dataReal(nx);
-	std::vector<double> dataImg(nx);
 	
-	GeoStar::Raster *rasBufferReal = img->create_raster("BufferReal", GeoStar::REAL32, nx, ny);
-	GeoStar::Raster *rasBufferImg = img->create_raster("BufferImg", GeoStar::REAL32, nx, ny);
+	GeoStar::Raster *rasBufferReal = img->create_scratch_raster("BufferReal", GeoStar::REAL32, nx, ny);
+	GeoStar::Raster *rasBufferImg = img->create_scratch_raster("BufferImg", GeoStar::REAL32, nx, ny);
+
+	// chunk caches: the row pass scans rows, the column pass scans columns of the buffers and outputs
+	ChunkCacheGuard inCache(this, rowScanCache());
+	rasBufferReal->tuneChunkCache(rasBufferReal->rowScanCache());
+	rasBufferImg->tuneChunkCache(rasBufferImg->rowScanCache());
 
-	//transform row by row
+	// the input is real: the imaginary parts stay 0 (out-of-place plans leave "in" alone)
+	for(int i=0;i<nx;i++) in[i][1]=0.0;
+
+	//transform row by row, reading/writing the interleaved fftw_complex arrays directly (stride 2)
 	for (int y = 0; y < ny; ++y) {	
           sliceFFTW.setY0(y);
-          read(sliceFFTW, dataReal);
-          for(int i=0;i<nx;i++) { 
-            in[i][0]=dataReal[i]; 
-            in[i][1]=0.0;
-          }
-          
+          read(sliceFFTW, &in[0][0], 2);
 	
           fftw_execute(plan);
           
-          for (int i = 0; i < nx; i++) {
-            dataReal[i] = out[i][0];
-            dataImg[i] = out[i][1];
-          }
-          rasBufferReal->write(sliceFFTW, dataReal);
-          rasBufferImg->write(sliceFFTW, dataImg);
+          rasBufferReal->write(sliceFFTW, &out[0][0], 2);
+          rasBufferImg->write(sliceFFTW, &out[0][1], 2);
           
 	}//endfor - row-by-row
         
@@ -1467,32 +1992,27 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	fftw_plan planCols;
 	planCols = fftw_plan_dft_1d(ny, inCols, outCols, FFTW_FORWARD, FFTW_ESTIMATE);
 
+	inCache.restore();
+	rasBufferReal->tuneChunkCache(rasBufferReal->columnScanCache());
+	rasBufferImg->tuneChunkCache(rasBufferImg->columnScanCache());
+	ChunkCacheGuard outRealCache(rasOutReal, rasOutReal->columnScanCache());
+	ChunkCacheGuard outImgCache(rasOutImg, rasOutImg->columnScanCache());
+
         sliceFFTW.setX0(0);
         sliceFFTW.setY0(0);
         sliceFFTW.setDeltaX(1);
         sliceFFTW.setDeltaY(ny);
 
-	dataReal.resize(ny);
-	dataImg.resize(ny);
-	
 	//transform col-by-col	
 	for (int x = 0; x < nx; ++x) {
           sliceFFTW.setX0(x);
-          rasBufferReal->read(sliceFFTW, dataReal);
-          rasBufferImg->read(sliceFFTW, dataImg);
-          for (int i = 0; i < ny; ++i) {
-            inCols[i][0] = dataReal[i];
-            inCols[i][1] = dataImg[i];
-          }
+          rasBufferReal->read(sliceFFTW, &inCols[0][0], 2);
+          rasBufferImg->read(sliceFFTW, &inCols[0][1], 2);
           
           fftw_execute(planCols);
           
-          for (int i = 0; i < ny; ++i) {
-            dataReal[i] = outCols[i][0];
-            dataImg[i] = outCols[i][1];
-          }
-          rasOutReal->write(sliceFFTW, dataReal);
-          rasOutImg->write(sliceFFTW, dataImg);
+          rasOutReal->write(sliceFFTW, &outCols[0][0], 2);
+          rasOutImg->write(sliceFFTW, &outCols[0][1], 2);
           
 	}//endfor - col-by-col
         
@@ -1524,31 +2044,26 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	plan = fftw_plan_dft_1d(ny, in, out, FFTW_BACKWARD, FFTW_ESTIMATE);
 
 	Slice sliceFFTW(0,0,1,ny);
-	std::vector<double> dataReal(ny);
-	std::vector<double> dataImg(ny);
 	
-	GeoStar::Raster *rasBufferReal = img->create_raster("BufferRealInv", GeoStar::REAL32, nx, ny);
-	GeoStar::Raster *rasBufferImg = img->create_raster("BufferImgInv", GeoStar::REAL32, nx, ny);
+	GeoStar::Raster *rasBufferReal = img->create_scratch_raster("BufferRealInv", GeoStar::REAL32, nx, ny);
+	GeoStar::Raster *rasBufferImg = img->create_scratch_raster("BufferImgInv", GeoStar::REAL32, nx, ny);
+
+	// chunk caches: the column pass scans columns, the row pass scans rows of the buffers and output
+	ChunkCacheGuard inCache(this, columnScanCache());
+	ChunkCacheGuard inImgCache(rasInImg, rasInImg->columnScanCache());
+	rasBufferReal->tuneChunkCache(rasBufferReal->columnScanCache());
+	rasBufferImg->tuneChunkCache(rasBufferImg->columnScanCache());
 
-	//transform col by col
+	//transform col by col, reading/writing the interleaved fftw_complex arrays directly (stride 2)
 	for (int x = 0; x < nx; ++x) {	
           sliceFFTW.setX0(x);
-          read(sliceFFTW, dataReal);
-          rasInImg->read(sliceFFTW, dataImg);
-          for(int i=0;i<ny;i++) { 
-            in[i][0]=dataReal[i]; 
-            in[i][1]=dataImg[i];
-          }
-          
+          read(sliceFFTW, &in[0][0], 2);
+          rasInImg->read(sliceFFTW, &in[0][1], 2);
           
           fftw_execute(plan);
           
-          for (int i = 0; i < ny; i++) {
-            dataReal[i] = out[i][0];
-            dataImg[i] = out[i][1];
-          }
-          rasBufferReal->write(sliceFFTW, dataReal);
-          rasBufferImg->write(sliceFFTW, dataImg);
+          rasBufferReal->write(sliceFFTW, &out[0][0], 2);
+          rasBufferImg->write(sliceFFTW, &out[0][1], 2);
           
 	}//endfor - col-by-col
         
@@ -1561,31 +2076,27 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	outRows = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nx);
 	fftw_plan planRows;
 	planRows = fftw_plan_dft_1d(nx, inRows, outRows, FFTW_BACKWARD, FFTW_ESTIMATE);
+
+	inCache.restore();
+	inImgCache.restore();
+	rasBufferReal->tuneChunkCache(rasBufferReal->rowScanCache());
+	rasBufferImg->tuneChunkCache(rasBufferImg->rowScanCache());
+	ChunkCacheGuard outCache(rasOut, rasOut->rowScanCache());
         
         sliceFFTW.setX0(0);
         sliceFFTW.setY0(0);
         sliceFFTW.setDeltaX(nx);
         sliceFFTW.setDeltaY(1);
         
-	dataReal.resize(nx);
-	dataImg.resize(nx);
-	
 	//transform row-by-row	
 	for (int y = 0; y < ny; ++y) {
           sliceFFTW.setY0(y);
-          rasBufferReal->read(sliceFFTW, dataReal);
-          rasBufferImg->read(sliceFFTW, dataImg);
-          for (int i = 0; i < nx; ++i) {
-            inRows[i][0] = dataReal[i];
-            inRows[i][1] = dataImg[i];
-          }
+          rasBufferReal->read(sliceFFTW, &inRows[0][0], 2);
+          rasBufferImg->read(sliceFFTW, &inRows[0][1], 2);
           
           fftw_execute(planRows);
           
-          for (int i = 0; i < nx; ++i) {
-            dataReal[i] = outRows[i][0];
-          }
-          rasOut->write(sliceFFTW, dataReal);
+          rasOut->write(sliceFFTW, &outRows[0][0], 2);
           
 	}//endfor - row-by-row
 
@@ -1631,30 +2142,21 @@ void Raster::drawFilledRectangle(const Slice &slice, const int radius, const int
 	double average = 0;
 	double newVal = 0;
 	
-        std::vector<double> data(nx);
-
-        Slice slice(0,0,nx,1);
-
-	for (int i = 0; i < ny; ++i) {
-          slice.setY0(i);
-          read(slice, data);
-	  for (int j = 0; j < nx; ++j) {
+	forEachBlock<double>([&](const Slice &, const std::vector<double> &data) {
+	  for (size_t j = 0; j < data.size(); ++j) {
             sum += data[j];
-	  }//endfor - nx
-	}//endfor - ny
+	  }//endfor
+	});
         
 	average = sum / (nx * ny);
         
-	for (int i = 0; i < ny; ++i) {
-          slice.setY0(i);
-          read(slice, data);
-	  for (int j = 0; j < nx; ++j) {
+	forEachBlock<double>(rasOut, [&](const Slice &, std::vector<double> &data) {
+	  for (size_t j = 0; j < data.size(); ++j) {
             newVal = contrast * (data[j] - average) + average;
             if (newVal < 0) newVal = 0;
             data[j] = newVal;
-	  }//endfor - nx
-          rasOut->write(slice, data);
-	}//endfor - ny
+	  }//endfor
+	});
         
  } //end - contrastCorrection
 
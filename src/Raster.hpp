@@ -16,13 +16,21 @@
 #include <iostream>
 #include <deque>
 #include <chrono>
+#include <functional>
+#include <mutex>
+#include <limits>
 
 #include "H5Cpp.h"
 
 #include "Slice.hpp"
 #include "WarpParameters.hpp"
 #include "TileIO.hpp"
+#include "TileWriter.hpp"
+#include "ApproxTransformer.hpp"
 #include "RasterType.hpp"
+#include "RasterTypeVisitor.hpp"
+#include "RasterLayout.hpp"
+#include "ChunkCache.hpp"
 #include "attributes.hpp"
 #include "Exceptions.hpp"
 #include "RasterFunction.hpp"
@@ -39,6 +47,7 @@ extern "C" {
 
 namespace GeoStar {
   class Image;
+  class File;
     class Slice;
 
 /** \brief Raster -- Implementation of raster operations for HDF5-based GeoStar files.
@@ -89,6 +98,49 @@ The constructors should only be called by the Image class: Image::createRaster.
   private:
       Image *image;
       std::string rastername;
+
+      // scratch rasters only (see Image::create_scratch_raster): the private file and image
+      //  holding the raster, deleted with it.  NULL for ordinary rasters.
+      File *scratchFile;
+      Image *scratchImage;
+      friend class Image;
+
+      // band-stack views only (see Image::create_band_stack): the band of the 3D dataset that this
+      //  raster shows, and whether the dataset is [y][x][band] (bandLast) or [band][y][x].
+      //  band is -1 for ordinary 2D rasters.
+      int band;
+      bool bandLast;
+
+      // create the 3D dataset of a band stack (called by Image::create_band_stack)
+      static void createBandStack(Image *image, const std::string &name, const RasterType &type,
+                                  const int &nx, const int &ny, const int &nbands, const bool &bandLast,
+                                  const RasterLayout &layout);
+
+      // select a (strided) window of this raster in its dataset's dataspace; for band-stack views,
+      //  in the raster's band plane.  start, count, stride are {y, x}.
+      void selectWindow(H5::DataSpace &space, const H5S_seloper_t &op, const hsize_t start[2],
+                        const hsize_t count[2], const hsize_t stride[2]) const;
+
+      // chunk width and height, in pixels of this raster; false if contiguous
+      bool chunkSize(long int &chunkX, long int &chunkY) const;
+
+      // true if no pixel of this raster was ever written and the fill value is value, so every
+      //  pixel already reads as value (writers can then skip pixels that would be set to value)
+      bool isBlankFill(const double &value) const;
+
+      // append mode (see appendRows): appendRow is the dataset row of the first pending row, or -1
+      //  when not appending; appendCapacity is the number of rows allocated in the dataset.  The
+      //  pending rows (pixels of pendingType, as raw bytes) are those not yet written, less than
+      //  one row of chunks.
+      long int appendRow;
+      long int appendCapacity;
+      long int pendingRows;
+      RasterType pendingType;
+      std::vector<unsigned char> pending;
+
+      // write the first nrows pending rows, growing the dataset geometrically if needed
+      void flushAppend(const long int &nrows);
+
       std::string fullRastername;
       std::string rastertype;
       RasterType  raster_datatype;
@@ -110,6 +162,15 @@ The constructors should only be called by the Image class: Image::createRaster.
       template <typename T>
       T getScaledPixelFromTile(long int oldY, long int oldX, double xDiff, double yDiff, Slice &sliceInput, Slice &scalingSlice,
                                TileIO<T> &reader);
+
+      // a colour given to set or a draw function, as a pixel of type T: rounded for integer types,
+      //  and clamped to the range of T (NaN is 0 for integer types)
+      template <typename T>
+      static T pixelColor(const double &color);
+
+      // the four edges (radius wide) of a rectangle, for drawRectangle and drawFilledRectangle
+      template <typename T>
+      void drawEdges(TileWriter<T> &writer, const Slice &slice, const int radius, const T &color);
       
       double dataAt(long int m, long int n, double *data, Slice &sliceInput);
       
@@ -129,6 +190,62 @@ The constructors should only be called by the Image class: Image::createRaster.
       template <typename T>
       void copyType(Raster *rasNew);
 
+      // copy the stored chunks, as they are, to rasNew (H5Dread_chunk/H5Dwrite_chunk).  Only done,
+      //  and true, when both have the same size, type, chunks and filters, and rasNew is empty.
+      bool copyChunks(Raster *rasNew) const;
+
+      // memory dataspace selecting n pixels, 'stride' elements apart (see read/write with a T* buffer)
+      H5::DataSpace stridedMemspace(const hsize_t &n, const long int &stride) const;
+
+      // size of one (uncompressed) chunk, in bytes; chunksX, chunksY get the number of chunks
+      //  across and down.  Returns 0 for contiguous rasters, which have no chunk cache.
+      size_t chunkGeometry(long int &chunksX, long int &chunksY) const;
+
+      // chunk caches for the access patterns of the built-in operations:
+      //   rowScanCache:    one full row of chunks (row-by-row reads/writes; each chunk used once)
+      //   columnScanCache: one full column of chunks (column-by-column reads/writes)
+      //   windowCache:     as much of the raster as the cache limit allows (random neighborhoods)
+      ChunkCache rowScanCache() const;
+      ChunkCache columnScanCache() const;
+      ChunkCache windowCache() const;
+
+      // switch to the given chunk cache for one operation, and return the old one, which the
+      //  operation gives back to setChunkCache when it is done.
+      ChunkCache tuneChunkCache(const ChunkCache &cache) const;
+
+      // tunes a raster's chunk cache for the scope of one operation: the raster gets its own
+      //  cache back when the guard goes away, also when the operation throws.
+      class ChunkCacheGuard {
+      private:
+          const Raster *raster;
+          ChunkCache old;
+
+          ChunkCacheGuard(const ChunkCacheGuard &) = delete;
+          ChunkCacheGuard &operator=(const ChunkCacheGuard &) = delete;
+
+      public:
+          ChunkCacheGuard(const Raster *raster, const ChunkCache &cache)
+              : raster(raster), old(raster->tuneChunkCache(cache)) {}
+
+          // switch to another cache for the next part of the operation
+          inline void retune(const ChunkCache &cache) {
+              raster->tuneChunkCache(cache);
+          }
+
+          // give the raster its cache back now, rather than at the end of the scope
+          inline void restore() {
+              raster->tuneChunkCache(old);
+          }
+
+          // destructors must not throw; a failed restore leaves the tuned cache, which is still valid
+          ~ChunkCacheGuard() {
+              try {
+                  raster->tuneChunkCache(old);
+              } catch (...) {
+              }
+          }
+      };
+
   public:
     H5::DataSet *rasterobj;
 
@@ -180,9 +297,14 @@ The constructors should only be called by the Image class: Image::createRaster.
     */
     Raster(Image *image, const std::string &name);
 
-      // creating a new Raster
+      // opening one band of a band stack (see Image::open_band), as a 2D raster
+      Raster(Image *image, const std::string &stackName, const int &band);
+
+      // creating a new Raster, whose size can be changed later (see setSize)
       // existence is an error
-      Raster(Image *image, const std::string &name, const RasterType &type);
+      // the layout is always chunked; a contiguous layout gets the default chunk size
+      Raster(Image *image, const std::string &name, const RasterType &type,
+             const RasterLayout &layout = RasterLayout());
 
     /** \brief Raster Constructor -- allows you to create a new raster
 
@@ -206,6 +328,11 @@ The constructors should only be called by the Image class: Image::createRaster.
     \param[in] ny
 	specifies y-size (vertical size) of new raster
 
+    \param[in] layout
+	optional storage layout (chunk size, shuffle/deflate/n-bit filters) of the new raster.
+	Defaults to RasterLayout(), which is tuned for large scenes; use RasterLayout::contiguous()
+	for unchunked, uncompressed storage.
+
     \returns
 	A valid raster object upon success
 
@@ -241,7 +368,7 @@ The constructors should only be called by the Image class: Image::createRaster.
 	so it is considered a Geostar file, else an exception is thrown
     */
       Raster(Image *image, const std::string &name, const RasterType &type,
-             const int &nx, const int &ny);
+             const int &nx, const int &ny, const RasterLayout &layout = RasterLayout());
 
 
       
@@ -439,10 +566,8 @@ The constructors should only be called by the Image class: Image::createRaster.
        using the Raster object destructor.
 
   */
-    // cleans up the H5::DataSet object
-    inline ~Raster() {
-      delete rasterobj;
-    }
+    // cleans up the H5::DataSet object, and the scratch file of a scratch raster
+    ~Raster();
 
       
       //H5::PredType getHdf5Type(const RasterType &type);
@@ -462,7 +587,8 @@ The constructors should only be called by the Image class: Image::createRaster.
 
    \param[in] outSlice
        This is a Slice object, set by the user, that describes the rectangular region in this raster, into
-       which to write the new data.
+       which to write the new data.  If the slice has a strideX/strideY, only every strideX'th pixel of
+       every strideY'th row is written, and the buffer holds just those getCountX()*getCountY() pixels.
    
    \param[in] buffer
        This is the templated vector, which holds the new data to write into this raster.
@@ -529,7 +655,47 @@ The constructors should only be called by the Image class: Image::createRaster.
       //
       // can call 'write(slice, bufr); don't need to say write<int>(slice, bufr)
       template<typename T>
-      void write(const Slice &outSlice, std::vector<T> buffer);
+      void write(const Slice &outSlice, const std::vector<T> &buffer);
+
+
+  /** \brief Raster::write (pointer version) writes caller-owned memory to a rectangular region of this raster.
+
+   Same as Raster::write with a vector, but the data comes from a raw pointer, so the caller can
+   write straight out of memory it already owns (a reused row buffer, an FFTW array, one band of
+   a pixel-interleaved buffer, ...) with no copy and no allocation.
+
+   \see  Raster, read
+
+   \param[in] outSlice
+       The rectangular region in this raster, into which to write the new data.
+
+   \param[in] buffer
+       Pointer to the first pixel.  Pixel (ix,iy) of the slice is buffer[(iy*countX+ix)*stride],
+       where countX = outSlice.getCountX() (= deltaX, unless the slice has a strideX).
+       The caller must provide at least (countX*countY-1)*stride+1 elements.
+
+   \param[in] stride
+       Distance, in elements of type T, between consecutive pixels in the buffer.  Defaults to 1
+       (densely packed).  Use e.g. 2 to write the real or imaginary part of an fftw_complex array.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterWriteError
+
+   \par Example
+       Write the imaginary parts of an FFTW output row into row "y" of raster "ras":
+       \code
+       fftw_complex *out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nx);
+       ...
+       Slice row(0,y,nx,1);
+       ras->write(row, &out[0][1], 2);
+       \endcode
+  */
+      template<typename T>
+      void write(const Slice &outSlice, const T *buffer, const long int &stride = 1);
 
       
       
@@ -544,7 +710,10 @@ The constructors should only be called by the Image class: Image::createRaster.
 
    \param[in] outSlice
        This is a Slice object, set by the user, that describes the rectangular region in this raster, from
-       which to read the data.
+       which to read the data.  If the slice has a strideX/strideY, only every strideX'th pixel of every
+       strideY'th row is read (a decimated read): the buffer gets getCountX()*getCountY() pixels, and
+       HDF5 only reads the chunks/rows that hold them.  E.g. Slice(0,0,nx,ny,0,8,8) gives a 1/64
+       thumbnail.
    
    \param[in] buffer
        This is the templated vector, which will hold the read-in data from this raster.
@@ -610,6 +779,131 @@ The constructors should only be called by the Image class: Image::createRaster.
       template<typename T>
       void read(const Slice &inSlice, std::vector<T> &buffer) const;
 
+
+  /** \brief Raster::read (pointer version) reads a rectangular region of this raster into caller-owned memory.
+
+   Same as Raster::read with a vector, but the data goes to a raw pointer, so the caller can
+   read straight into memory it already owns with no copy, no allocation and no resize.
+
+   \see  Raster, write
+
+   \param[in] inSlice
+       The rectangular region in this raster, from which to read the data.
+
+   \param[out] buffer
+       Pointer to the first pixel.  Pixel (ix,iy) of the slice goes to buffer[(iy*countX+ix)*stride];
+       the elements in between are not touched.  countX = inSlice.getCountX() (= deltaX, unless the
+       slice has a strideX; see read with a vector).
+       The caller must provide at least (countX*countY-1)*stride+1 elements.
+
+   \param[in] stride
+       Distance, in elements of type T, between consecutive pixels in the buffer.  Defaults to 1.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterReadError
+
+   \par Example
+       Read band "b" of an "nb"-band image into a pixel-interleaved buffer:
+       \code
+       std::vector<float> bip(nx*ny*nb);
+       Slice all(0,0,nx,ny);
+       bands[b]->read(all, &bip[b], nb);
+       \endcode
+  */
+      template<typename T>
+      void read(const Slice &inSlice, T *buffer, const long int &stride = 1) const;
+
+
+
+  /** \brief Raster::readMany reads many small rectangular regions of this raster in one HDF5 call.
+
+   Raster::readMany reads all of the given slices at once: it selects the union of the slices in
+   the raster's dataspace (H5S_SELECT_OR), reads the union with a single HDF5 read, and then copies
+   each slice's pixels into its own buffer.  For thousands of tiny windows (GCP chips, point
+   samples, edge probes) this saves the per-call selection and dispatch cost of Raster::read.
+
+   \see  read
+
+   \param[in] slices
+       The rectangular regions to read.  They may overlap.
+
+   \param[out] buffers
+       Resized to slices.size(); buffers[i] gets the pixels of slices[i], as Raster::read would.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterReadError, also if a slice is not inside the raster.
+
+   \par Example
+       Read a 3x3 chip around each of a list of points:
+       \code
+       std::vector<GeoStar::Slice> chips;
+       for (size_t i = 0; i < points.size(); i++)
+           chips.push_back(GeoStar::Slice(points[i].x-1, points[i].y-1, 3, 3));
+       std::vector<std::vector<float> > data;
+       ras->readMany(chips, data);
+       \endcode
+
+   \par Details
+       Slices with a strideX/strideY are read one at a time, with Raster::read.
+       Pixels shared by overlapping slices are read once.
+  */
+      template<typename T>
+      void readMany(const std::vector<Slice> &slices, std::vector<std::vector<T> > &buffers) const;
+
+
+
+  /** \brief Raster::setChunkCache changes the HDF5 chunk cache of this raster.
+
+   Raster::setChunkCache sets the size, number of hash slots and preemption policy of the HDF5
+   chunk cache used for this raster, which otherwise comes from the File (see the File constructor).
+
+   \see  ChunkCache, getChunkCache, File
+
+   \param[in] cache
+       The new chunk cache settings.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterOpenError
+
+   \par Example
+       Give a raster that is read in many small random windows a 64 MiB cache:
+       \code
+       ras->setChunkCache(GeoStar::ChunkCache(64*1048576));
+       \endcode
+
+   \par Details
+       HDF5 only applies chunk cache settings when a dataset is opened, so the raster's dataset is
+       closed and opened again; this also drops any chunks already in the cache.
+       It does nothing for contiguous rasters, which have no chunk cache.
+       Other Raster objects opened on the same raster share its cache, and while any of them is
+       still open the new settings cannot take effect.
+       The built-in operations (FFT_2D, warp, rotate, ...) tune the cache for their own access
+       pattern while they run, and then restore the cache that was set here.
+       Changing the cache does not change the pixels, so this is a const method.
+  */
+      void setChunkCache(const ChunkCache &cache) const;
+
+      // return the chunk cache settings in use for this raster
+      ChunkCache getChunkCache() const;
+
+      // the chunk width and height of this raster, in pixels; false (and nothing set) if it is
+      //  not chunked.  Readers align their tiles to these (see TileIO).
+      inline bool getChunkSize(long int &chunkX, long int &chunkY) const {
+          return chunkSize(chunkX, chunkY);
+      }
+
       
 
 
@@ -813,6 +1107,55 @@ The constructors should only be called by the Image class: Image::createRaster.
 
       // NEED TO DOCUMENT (doxygen) !!!!!!!!!
       void setSize(long int nx, long int ny);
+
+  /** \brief Raster::appendRows adds rows to the bottom of a growable raster.
+
+   Raster::appendRows is for data that arrives a few lines at a time, such as push-broom or SAR
+   line data: the rows are added after the last row of the raster, and finishAppend sets the
+   final size.
+
+   \see setSize, finishAppend, write
+
+   \param[in] buffer
+       The new rows, one after the other; at least nrows*get_nx() pixels.
+
+   \param[in] nrows
+       The number of rows to add.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterImmutableError, if the raster was not created growable (or is a band of a band stack).
+       RasterWriteError
+
+   \par Example
+       \code
+       GeoStar::Raster *ras = img->create_raster("lines", GeoStar::INT16U);
+       ras->setSize(2048, 0);           // the line width; no rows yet
+       std::vector<uint16_t> lines(2048*16);
+       while (feed.next(lines)) ras->appendRows(lines, 16);
+       ras->finishAppend();
+       \endcode
+
+   \par Details
+       Rows are buffered until a whole row of chunks is complete, and written one row of chunks
+       at a time, so every chunk is written (and compressed) once.  The dataset is extended in
+       whole rows of chunks, doubling its size each time, so there are only a few extend calls
+       however many rows come in.  Until finishAppend is called (or the Raster is deleted),
+       get_ny() is the allocated size, which may include empty rows at the bottom; finishAppend
+       writes the buffered rows and trims the raster to the rows appended.
+
+       Appending starts at the raster's current last row, so use setSize(nx, 0) on a new raster
+       to set the line width first.
+  */
+      template <typename T>
+      void appendRows(const std::vector<T> &buffer, const long int &nrows);
+
+      // writes any rows buffered by appendRows and trims the raster to the rows appended.
+      //  Called by the destructor, if needed.
+      void finishAppend();
       
       void setWKT(std::string &wkt);
       std::string getWKT();
@@ -954,6 +1297,10 @@ The constructors should only be called by the Image class: Image::createRaster.
     void copy(const Slice &inslice, Raster *ras_out) const;
  
       
+      // copies all of this raster into rasNew, which has the same size.
+      //  When rasNew is new and has the same type and layout (chunks and filters) as this raster,
+      //  the stored chunks are copied as they are, without decompressing them; otherwise the
+      //  pixels are converted to rasNew's type.
       void copy(Raster *rasNew);
 
 
@@ -1011,6 +1358,9 @@ The constructors should only be called by the Image class: Image::createRaster.
 
     \Par Details
 	note the slice is a bare C-array - passing in a vector slice here will not work
+
+	value is rounded and clamped to the raster's pixel type.  A slice covering the whole raster
+	is set as setPixels sets it: as the fill value, without writing pixels, when it can be.
     */
     void set(const Slice &slice, const int &value);
 
@@ -1687,7 +2037,7 @@ int main() {
           \endcode
 
           \par Details
-            This function uses getParent() to be able to make a new raster in "this" raster's Image. It then uses the add() function on that raster to store the summed rasters.
+            The result is a scratch raster (Image::create_scratch_raster), so it is not stored in the file; copy it to a raster of the Image to keep it. This function then uses the add() function on that raster to store the summed rasters.
           */
         GeoStar::Raster * operator+(const GeoStar::Raster & r2);
 
@@ -1728,7 +2078,7 @@ int main() {
             \endcode
 
             \par Details
-              This function uses getParent() to be able to make a new raster in "this" raster's Image. It then uses the subtract() function on that raster to store the difference between the rasters.
+              The result is a scratch raster (Image::create_scratch_raster), so it is not stored in the file; copy it to a raster of the Image to keep it. This function then uses the subtract() function on that raster to store the difference between the rasters.
             */
         GeoStar::Raster * operator-(const GeoStar::Raster & r2);
 
@@ -1769,7 +2119,7 @@ int main() {
             \endcode
 
             \par Details
-              This function uses getParent() to be able to make a new raster in "this" raster's Image. It then uses the multiply() function on that raster to store the product of the rasters.
+              The result is a scratch raster (Image::create_scratch_raster), so it is not stored in the file; copy it to a raster of the Image to keep it. This function then uses the multiply() function on that raster to store the product of the rasters.
             */
         GeoStar::Raster * operator*(const GeoStar::Raster & r2);
 
@@ -1810,7 +2160,7 @@ int main() {
             \endcode
 
             \par Details
-              This function uses getParent() to be able to make a new raster in "this" raster's Image. It then uses the divide() function on that raster to store the quotient of the rasters.
+              The result is a scratch raster (Image::create_scratch_raster), so it is not stored in the file; copy it to a raster of the Image to keep it. This function then uses the divide() function on that raster to store the quotient of the rasters.
             */
         GeoStar::Raster * operator/(const GeoStar::Raster & r2);
 
@@ -1851,7 +2201,7 @@ int main() {
             \endcode
 
             \par Details
-              This function uses getParent() to be able to make a new raster in "this" raster's Image. It then iterates through every pixel and adds the value to each.
+              The result is a scratch raster (Image::create_scratch_raster), so it is not stored in the file; copy it to a raster of the Image to keep it. This function then iterates through every pixel and adds the value to each.
             */
         GeoStar::Raster * operator+(const float & val);
 
@@ -1892,7 +2242,7 @@ int main() {
             \endcode
 
             \par Details
-              This function uses getParent() to be able to make a new raster in "this" raster's Image. It then iterates through every pixel and adds the value to each.
+              The result is a scratch raster (Image::create_scratch_raster), so it is not stored in the file; copy it to a raster of the Image to keep it. This function then iterates through every pixel and adds the value to each.
             */
         GeoStar::Raster * operator-(const float & val);
         GeoStar::Raster * operator*(const float & val);
@@ -2487,18 +2837,33 @@ int main() {
 
        
 #include "Raster_bitmap.hpp"
+#include "Raster_block.hpp"
 #include "Raster_flip.hpp"
 #include "Raster_histogram.hpp"
 #include "Raster_minmax.hpp"
+#include "Raster_overview.hpp"
 #include "Raster_polygon.hpp"
 #include "Raster_reproject.hpp"
+#include "Raster_resample.hpp"
 #include "Raster_rotate.hpp"
 #include "Raster_scale.hpp"
 #include "Raster_set.hpp"
 #include "Raster_warp.hpp"
 
   }; // end class: Raster
-  
+
+    // the getHdf5Type specializations, defined in Raster.cpp (declared here so that every user gets them):
+    template <>  H5::PredType Raster::getHdf5Type<uint8_t>();
+    template <>  H5::PredType Raster::getHdf5Type<int8_t>();
+    template <>  H5::PredType Raster::getHdf5Type<uint16_t>();
+    template <>  H5::PredType Raster::getHdf5Type<int16_t>();
+    template <>  H5::PredType Raster::getHdf5Type<uint32_t>();
+    template <>  H5::PredType Raster::getHdf5Type<int32_t>();
+    template <>  H5::PredType Raster::getHdf5Type<uint64_t>();
+    template <>  H5::PredType Raster::getHdf5Type<int64_t>();
+    template <>  H5::PredType Raster::getHdf5Type<float>();
+    template <>  H5::PredType Raster::getHdf5Type<double>();
+
 }// end namespace GeoStar
 
 
@@ -0,0 +1,187 @@
+// RasterLayout.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "H5Cpp.h"
+
+#include "RasterLayout.hpp"
+
+namespace GeoStar {
+
+    RasterLayout::RasterLayout() {
+        // 256x256 chunks keep a REAL64 chunk (512 KB) inside the default HDF5 chunk cache,
+        //  while a 20k x 20k scene is still only ~6000 chunks.
+        this->chunkX = 256;
+        this->chunkY = 256;
+        this->shuffle = true;
+        this->deflateLevel = 4;
+        this->nbitPrecision = 0;
+        this->fillSet = false;
+        this->fillValue = 0.0;
+    }
+
+
+    RasterLayout::RasterLayout(const long int &chunkX, const long int &chunkY, const bool &shuffle,
+                               const int &deflateLevel, const int &nbitPrecision) {
+        this->shuffle = shuffle;
+        this->fillSet = false;
+        this->fillValue = 0.0;
+        setChunkSize(chunkX, chunkY);
+        setDeflateLevel(deflateLevel);
+        setNbitPrecision(nbitPrecision);
+    }// end-RasterLayout-constructor
+
+
+    RasterLayout RasterLayout::contiguous() {
+        return RasterLayout(0, 0, false, 0, 0);
+    }
+
+
+    void RasterLayout::setChunkSize(const long int &chunkX, const long int &chunkY) {
+        // a zero (or negative) size in either direction means contiguous:
+        if (chunkX <= 0 || chunkY <= 0) {
+            this->chunkX = 0;
+            this->chunkY = 0;
+        } else {
+            this->chunkX = chunkX;
+            this->chunkY = chunkY;
+        }
+    }
+
+
+    void RasterLayout::setDeflateLevel(const int &deflateLevel) {
+        this->deflateLevel = std::max(0, std::min(9, deflateLevel));
+    }
+
+
+    void RasterLayout::setNbitPrecision(const int &nbitPrecision) {
+        this->nbitPrecision = std::max(0, nbitPrecision);
+    }
+
+
+
+    H5::DSetCreatPropList RasterLayout::createPropList(const H5::PredType &h5Type, const long int &nx,
+                                                       const long int &ny, const bool &growable) const {
+        H5::DSetCreatPropList cparms;
+
+        long int cx = chunkX;
+        long int cy = chunkY;
+
+        if (!isChunked()) {
+            // contiguous storage cannot grow, and filters need chunks:
+            if (!growable) {
+                addAllocation(cparms);
+                return cparms;
+            }
+            RasterLayout defaultLayout;
+            cx = defaultLayout.getChunkX();
+            cy = defaultLayout.getChunkY();
+        }
+
+        // Fixed-size rasters: HDF5 wants chunks no bigger than the dataset, and there's no
+        //  point in storing mostly-empty chunks for small rasters.  (An empty raster still needs
+        //  chunks of at least 1.)
+        if (!growable) {
+            cx = std::min(cx, std::max(1L, nx));
+            cy = std::min(cy, std::max(1L, ny));
+        }
+
+        hsize_t chunk_dims[2];
+        chunk_dims[0] = cy;
+        chunk_dims[1] = cx;
+        cparms.setChunk(2, chunk_dims);
+
+        // the filters only apply to chunked datasets:
+        if (isChunked()) addFilters(cparms, h5Type);
+        addAllocation(cparms);
+
+        return cparms;
+    }// end: createPropList
+
+
+
+    H5::DSetCreatPropList RasterLayout::createPropList(const H5::PredType &h5Type, const long int &nx,
+                                                       const long int &ny, const long int &nbands,
+                                                       const bool &bandLast) const {
+        H5::DSetCreatPropList cparms;
+        if (!isChunked()) {
+            addAllocation(cparms);
+            return cparms;
+        }
+
+        long int cx = std::min(chunkX, nx);
+        long int cy = std::min(chunkY, ny);
+        long int nb = std::max(1L, nbands);
+        // a chunk holds all the bands: keep it to 1M pixels (or one 2D chunk, if bigger), so
+        //  hyperspectral stacks don't get huge chunks:
+        while (cx*cy*nb > std::max(1048576L, chunkX*chunkY) && (cx > 16 || cy > 16)) {
+            cx = std::max(1L, cx/2);
+            cy = std::max(1L, cy/2);
+        }
+
+        hsize_t chunk_dims[3];
+        if (bandLast) {
+            chunk_dims[0] = cy;
+            chunk_dims[1] = cx;
+            chunk_dims[2] = nb;
+        } else {
+            chunk_dims[0] = nb;
+            chunk_dims[1] = cy;
+            chunk_dims[2] = cx;
+        }
+        cparms.setChunk(3, chunk_dims);
+        addFilters(cparms, h5Type);
+        addAllocation(cparms);
+        return cparms;
+    }// end: createPropList
+
+
+
+    void RasterLayout::addFilters(H5::DSetCreatPropList &cparms, const H5::PredType &h5Type) const {
+        // filters are applied in the order added:
+        //   n-bit first (it packs the significant bits), then shuffle, then deflate.
+        if (nbitPrecision > 0 && h5Type.getClass() == H5T_INTEGER
+            && (size_t)nbitPrecision < 8*h5Type.getSize()
+            && H5Zfilter_avail(H5Z_FILTER_NBIT) > 0) {
+            cparms.setNbit();
+        }
+
+        if (shuffle && h5Type.getSize() > 1 && H5Zfilter_avail(H5Z_FILTER_SHUFFLE) > 0) {
+            cparms.setShuffle();
+        }
+
+        if (deflateLevel > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+            cparms.setDeflate(deflateLevel);
+        }
+    }// end: addFilters
+
+
+
+    void RasterLayout::addAllocation(H5::DSetCreatPropList &cparms) const {
+        // chunks are allocated when first written (contiguous storage: on the first write), and
+        //  never pre-filled: unallocated storage reads back as the fill value.
+        if (cparms.getLayout() == H5D_CHUNKED) cparms.setAllocTime(H5D_ALLOC_TIME_INCR);
+        cparms.setFillTime(H5D_FILL_TIME_IFSET);
+        if (fillSet) cparms.setFillValue(H5::PredType::NATIVE_DOUBLE, &fillValue);
+    }// end: addAllocation
+
+
+
+    H5::DataType RasterLayout::storageType(const H5::PredType &h5Type) const {
+        if (isChunked() && nbitPrecision > 0 && h5Type.getClass() == H5T_INTEGER
+            && (size_t)nbitPrecision < 8*h5Type.getSize()
+            && H5Zfilter_avail(H5Z_FILTER_NBIT) > 0) {
+            H5::IntType nbitType(h5Type);
+            nbitType.setPrecision(nbitPrecision);
+            return nbitType;
+        }
+        return h5Type;
+    }// end: storageType
+
+}// end namespace GeoStar
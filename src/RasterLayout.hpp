@@ -0,0 +1,154 @@
+// RasterLayout.hpp
+//
+//----------------------------------------
+#ifndef RASTERLAYOUT_HPP_
+#define RASTERLAYOUT_HPP_
+
+
+#include <string>
+#include <vector>
+
+#include "H5Cpp.h"
+
+
+namespace GeoStar {
+
+/** \brief RasterLayout -- the on-disk storage layout of a GeoStar raster.
+
+This class describes how the pixels of a new raster are laid out in the HDF5 file: whether the
+dataset is contiguous or split into rectangular chunks, how big the chunks are, and which HDF5
+filters (shuffle, deflate, n-bit) are applied to each chunk.
+
+\see Image, Raster, Slice
+
+\par Usage Overview
+A RasterLayout is passed to Image::create_raster (or the Raster constructors) when a raster is
+created.  The layout cannot be changed once the raster exists.
+
+The default-constructed layout is tuned for large (20k X 20k) scenes: 256 X 256 chunks, with the
+shuffle and deflate filters turned on.  A window read then costs only the few chunks it overlaps,
+instead of a scan of every full row, and the file is typically 2-4 times smaller on disk.
+
+Use RasterLayout::contiguous() to get the old, unchunked and uncompressed, layout.
+
+\par Details
+Chunk sizes are clamped to the raster size for fixed-size rasters, so small rasters do not waste
+space on mostly-empty chunks.
+Growable (mutable) rasters are always chunked, since HDF5 requires chunking to extend a dataset.
+The n-bit filter is only applied to integer rasters, and only when nbitPrecision is smaller than
+the size of the raster type.
+Filters that are not available in the HDF5 library in use are silently skipped.
+
+Chunks are allocated only when they are first written, so a raster that is only partly written
+(a warp with empty borders, a copy under a sparse bitmap) never stores its untouched chunks.  They
+read back as the fill value: 0, unless setFillValue was used.
+*/
+  class RasterLayout {
+
+  private:
+      // add the n-bit, shuffle and deflate filters (as configured) to a chunked property list
+      void addFilters(H5::DSetCreatPropList &cparms, const H5::PredType &h5Type) const;
+
+      // add the allocation time and fill value settings to a property list
+      void addAllocation(H5::DSetCreatPropList &cparms) const;
+
+      long int chunkX;        // chunk width, in pixels; 0 means contiguous
+      long int chunkY;        // chunk height, in pixels; 0 means contiguous
+      bool shuffle;           // byte-shuffle filter, applied before deflate
+      int deflateLevel;       // gzip level, 1..9; 0 means no deflate
+      int nbitPrecision;      // number of significant bits for integer rasters; 0 means no n-bit
+      bool fillSet;           // was a fill value given?
+      double fillValue;       // value of pixels that were never written, if fillSet
+
+  public:
+      // default layout: tuned for large scenes (256x256 chunks, shuffle + deflate)
+      RasterLayout();
+
+      RasterLayout(const long int &chunkX, const long int &chunkY, const bool &shuffle = true,
+                   const int &deflateLevel = 4, const int &nbitPrecision = 0);
+
+      // unchunked, unfiltered storage: the original GeoStar layout
+      static RasterLayout contiguous();
+
+      // return chunk width
+      inline long int getChunkX() const {
+          return chunkX;
+      }
+
+      // return chunk height
+      inline long int getChunkY() const {
+          return chunkY;
+      }
+
+      // return whether the shuffle filter is used
+      inline bool getShuffle() const {
+          return shuffle;
+      }
+
+      // return deflate level
+      inline int getDeflateLevel() const {
+          return deflateLevel;
+      }
+
+      // return n-bit precision
+      inline int getNbitPrecision() const {
+          return nbitPrecision;
+      }
+
+      // is this a chunked layout?
+      inline bool isChunked() const {
+          return (chunkX > 0 && chunkY > 0);
+      }
+
+      // set the chunk size
+      void setChunkSize(const long int &chunkX, const long int &chunkY);
+
+      // turn the shuffle filter on/off
+      inline void setShuffle(const bool &shuffle) {
+          this->shuffle = shuffle;
+      }
+
+      // set the deflate level (0 turns deflate off)
+      void setDeflateLevel(const int &deflateLevel);
+
+      // set the n-bit precision (0 turns n-bit off)
+      void setNbitPrecision(const int &nbitPrecision);
+
+      // set the value that pixels have until they are written (converted to the raster type)
+      inline void setFillValue(const double &value) {
+          this->fillSet = true;
+          this->fillValue = value;
+      }
+
+      // return whether a fill value was given; without one, unwritten pixels are 0
+      inline bool hasFillValue() const {
+          return fillSet;
+      }
+
+      // return the fill value (0 if none was given)
+      inline double getFillValue() const {
+          return fillSet ? fillValue : 0.0;
+      }
+
+      // build the HDF5 dataset-creation property list for a raster of the given size and type.
+      // nx, ny are the current raster size; growable is true for mutable rasters.
+      H5::DSetCreatPropList createPropList(const H5::PredType &h5Type, const long int &nx,
+                                           const long int &ny, const bool &growable) const;
+
+      // the same, for a band-stacked 3D dataset of nbands bands of nx X ny (see Image::create_band_stack).
+      //  Every chunk holds all of the bands of a chunkX X chunkY window (shrunk for many bands), so a
+      //  pixel's spectrum is in one chunk; bandLast puts the band dimension last, else first.
+      H5::DSetCreatPropList createPropList(const H5::PredType &h5Type, const long int &nx,
+                                           const long int &ny, const long int &nbands,
+                                           const bool &bandLast) const;
+
+      // the HDF5 datatype used to store the pixels on disk, which differs from the
+      //  native type only when the n-bit filter reduces the precision.
+      H5::DataType storageType(const H5::PredType &h5Type) const;
+
+  }; // end class: RasterLayout
+
+}// end namespace GeoStar
+
+
+#endif //RASTERLAYOUT_HPP_
@@ -0,0 +1,103 @@
+// RasterTypeVisitor.hpp
+//
+//----------------------------------------
+#ifndef RASTERTYPEVISITOR_HPP_
+#define RASTERTYPEVISITOR_HPP_
+
+
+#include <string>
+#include <cstdint>
+
+#include "RasterType.hpp"
+#include "Exceptions.hpp"
+
+
+namespace GeoStar {
+
+    // An empty "tag" object, carrying a C++ pixel type, that is passed to a RasterType visitor.
+    template <typename T>
+    struct RasterTypeTag {
+        typedef T type;
+    };
+
+
+    // The RasterType that corresponds to a C++ pixel type, e.g. RasterTypeOf<int16_t>::value == INT16S
+    template <typename T> struct RasterTypeOf;
+    template <> struct RasterTypeOf<uint8_t>  { static const RasterType value = INT8U; };
+    template <> struct RasterTypeOf<int8_t>   { static const RasterType value = INT8S; };
+    template <> struct RasterTypeOf<uint16_t> { static const RasterType value = INT16U; };
+    template <> struct RasterTypeOf<int16_t>  { static const RasterType value = INT16S; };
+    template <> struct RasterTypeOf<uint32_t> { static const RasterType value = INT32U; };
+    template <> struct RasterTypeOf<int32_t>  { static const RasterType value = INT32S; };
+    template <> struct RasterTypeOf<uint64_t> { static const RasterType value = INT64U; };
+    template <> struct RasterTypeOf<int64_t>  { static const RasterType value = INT64S; };
+    template <> struct RasterTypeOf<float>    { static const RasterType value = REAL32; };
+    template <> struct RasterTypeOf<double>   { static const RasterType value = REAL64; };
+
+
+    /** \brief visitRasterType calls a templated kernel with the C++ pixel type of a RasterType.
+
+   visitRasterType is the one place where a run-time RasterType is turned into a compile-time
+   pixel type.  The visitor is called with a RasterTypeTag<T>, where T is the native pixel type
+   of the RasterType (uint8_t for INT8U, int16_t for INT16S, ..., double for REAL64), so the
+   kernel is instantiated for every supported type and the data stays in its native width.
+
+   \see RasterType, Raster
+
+   \param[in] type
+       The RasterType to dispatch on.
+   \param[in] visitor
+       A callable taking a RasterTypeTag<T>; usually a generic lambda.
+   \param[in] name
+       The name of the raster, used in the exception message.
+
+   \returns
+       whatever the visitor returns.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterUnsupportedTypeError, for the complex types.
+
+   \par Example
+       \code
+       return visitRasterType(raster_datatype, [&](auto tag) {
+           typedef typename decltype(tag)::type T;
+           return warpType<T>(warpInfo, in, out, outRaster);
+       }, fullRastername);
+       \endcode
+  */
+    template <typename Visitor>
+    auto visitRasterType(const RasterType &type, Visitor visitor, const std::string &name)
+        -> decltype(visitor(RasterTypeTag<uint8_t>())) {
+        switch(type) {
+            case INT8U:
+                return visitor(RasterTypeTag<uint8_t>());
+            case INT8S:
+                return visitor(RasterTypeTag<int8_t>());
+            case INT16U:
+                return visitor(RasterTypeTag<uint16_t>());
+            case INT16S:
+                return visitor(RasterTypeTag<int16_t>());
+            case INT32U:
+                return visitor(RasterTypeTag<uint32_t>());
+            case INT32S:
+                return visitor(RasterTypeTag<int32_t>());
+            case INT64U:
+                return visitor(RasterTypeTag<uint64_t>());
+            case INT64S:
+                return visitor(RasterTypeTag<int64_t>());
+            case REAL32:
+                return visitor(RasterTypeTag<float>());
+            case REAL64:
+                return visitor(RasterTypeTag<double>());
+            //case COMPLEX_INT16:
+            //    return
+            default:
+                throw_RasterUnsupportedTypeError(name);
+        }
+    }// end: visitRasterType
+
+}// end namespace GeoStar
+
+
+#endif // RASTERTYPEVISITOR_HPP_
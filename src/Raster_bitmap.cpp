@@ -34,36 +34,10 @@ namespace GeoStar {
         //}
         
         // Now, call the templated flipType<>() method, based on the new raster type:
-        switch(raster_datatype) {
-            case INT8U:
-                return countBitmapOnPixelsType<uint8_t>(in, true);
-                /*
-                 case INT8S:
-                 return countBitmapOnPixelsType<int8_t>(in, false);
-                 case INT16U:
-                 return countBitmapOnPixelsType<uint16_t>(in, true);
-                 case INT16S:
-                 return countBitmapOnPixelsType<int16_t>(in, false);
-                 case INT32U:
-                 return countBitmapOnPixelsType<uint32_t>(in, true);
-                 case INT32S:
-                 return countBitmapOnPixelsType<int32_t>(in, false);
-                 case INT64U:
-                 return countBitmapOnPixelsType<uint64_t>(in, true);
-                 case INT64S:
-                 return countBitmapOnPixelsType<int64_t>(in, false);
-                 */
-            case REAL32:
-                return countBitmapOnPixelsType<float>(in, false);
-                
-            case REAL64:
-                return countBitmapOnPixelsType<double>(in, false);
-                
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        return visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return countBitmapOnPixelsType<T>(in, !std::numeric_limits<T>::is_signed);
+        }, fullRastername);
         return 0;
     }
     
@@ -150,36 +124,10 @@ namespace GeoStar {
             
         
         // Now, call the templated flipType<>() method, based on the new raster type:
-        switch(raster_datatype) {
-            case INT8U:
-                return bitmapType<uint8_t>(rasNew, bitmapFn);
-                /*
-                    case INT8S:
-                    return bitmapType<int8_t>(rasNew, bitmapFn);
-                    case INT16U:
-                    return bitmapType<uint16_t>(rasNew, bitmapFn);
-                    case INT16S:
-                    return bitmapType<int16_t>(rasNew, bitmapFn);
-                    case INT32U:
-                    return bitmapType<uint32_t>(rasNew, bitmapFn);
-                    case INT32S:
-                    return bitmapType<int32_t>(rasNew, bitmapFn);
-                    case INT64U:
-                    return bitmapType<uint64_t>(rasNew, bitmapFn);
-                    case INT64S:
-                    return bitmapType<int64_t>(rasNew, bitmapFn);
-                    */
-            case REAL32:
-                return bitmapType<float>(rasNew, bitmapFn);
-                    
-            case REAL64:
-                return bitmapType<double>(rasNew, bitmapFn);
-
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        return visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return bitmapType<T>(rasNew, bitmapFn);
+        }, fullRastername);
         return NULL;
     }
 
@@ -190,9 +138,8 @@ namespace GeoStar {
     Raster* Raster::bitmapType(Raster *outRaster, RasterFunction *bitmapFn) {
         
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        GeoStar::Slice tileDescriptor(0,0,8,8);
-        int maxNumberSlicesInRam = 70;
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
+        // one output row at a time: tiles sized to the input's chunks, enough of them for a row sweep
+        GeoStar::TileIO<T> reader(this, get_nx(), 2);
         
         GeoStar::Slice scalingSlice(0,0,2,2,4);
         
@@ -270,36 +217,10 @@ namespace GeoStar {
         
         
         // Now, call the templated flipType<>() method, based on the new raster type:
-        switch(raster_datatype) {
-            case INT8U:
-            return copyUnderBitmapType<uint8_t>(bitmap, rasNew);
-            /*
-             case INT8S:
-             return bitmapType<int8_t>(rasNew);
-             case INT16U:
-             return bitmapType<uint16_t>(rasNew);
-             case INT16S:
-             return bitmapType<int16_t>(rasNew);
-             case INT32U:
-             return bitmapType<uint32_t>(rasNew);
-             case INT32S:
-             return bitmapType<int32_t>(rasNew);
-             case INT64U:
-             return bitmapType<uint64_t>(rasNew);
-             case INT64S:
-             return bitmapType<int64_t>(rasNew);
-             */
-            case REAL32:
-            return copyUnderBitmapType<float>(bitmap, rasNew);
-            
-            case REAL64:
-            return copyUnderBitmapType<double>(bitmap, rasNew);
-            
-            //case COMPLEX_INT16:
-            //    return
-            default:
-            throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        return visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return copyUnderBitmapType<T>(bitmap, rasNew);
+        }, fullRastername);
         return NULL;
     }
     
@@ -308,11 +229,10 @@ namespace GeoStar {
     Raster* Raster::copyUnderBitmapType(Raster *bitmap, Raster *outRaster) {
         
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        GeoStar::Slice tileDescriptor(0,0,8,8);
-        int maxNumberSlicesInRam = 70;
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
-        GeoStar::TileIO<uint8_t> readerBitMap(bitmap, tileDescriptor, maxNumberSlicesInRam);
-        GeoStar::TileIO<T> readerDest(outRaster, tileDescriptor, maxNumberSlicesInRam);
+        // one row at a time: tiles sized to each raster's chunks, enough of them for a row sweep
+        GeoStar::TileIO<T> reader(this, get_nx(), 2);
+        GeoStar::TileIO<uint8_t> readerBitMap(bitmap, bitmap->get_nx(), 2);
+        GeoStar::TileIO<T> readerDest(outRaster, outRaster->get_nx(), 2);
 
         GeoStar::Slice scalingSlice(0,0,2,2,4);
         
@@ -349,6 +269,7 @@ namespace GeoStar {
         
         for (long int i = yOut0; i < yOutMax; i++) {
             oldY = i;
+            long int firstOn = -1, lastOn = -1;   // the part of the row under the bitmap
             
             for (long int j = xOut0; j < xOutMax; j++) {
                 oldX = j;
@@ -359,11 +280,18 @@ namespace GeoStar {
                 destPixelVal = getScaledPixelFromTile<T>(oldY,oldX,0.0,0.0,sliceInput,
                                                                  scalingSlice,readerDest);
                 // the bitmap is '1' replace the destination pixel value with this raster's pixel value:
-                if (bitmapVal == 1) newData[j] = srcPixelVal;
+                if (bitmapVal == 1) {
+                    newData[j] = srcPixelVal;
+                    if (firstOn < 0) firstOn = j;
+                    lastOn = j;
+                }
                 else newData[j] = destPixelVal;
             }
-            sliceOut.setY0(i);
-            rasNew->write(sliceOut,newData);
+            // pixels off the bitmap keep their value, so only the span under the bitmap is written:
+            //  rows (and chunks) that the bitmap doesn't touch are never written, or allocated.
+            if (firstOn < 0) continue;
+            Slice span(firstOn, i, lastOn - firstOn + 1, 1);
+            rasNew->write(span, &newData[firstOn]);
         }
         
         std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
@@ -374,14 +302,35 @@ namespace GeoStar {
     }
 
     template long int Raster::countBitmapOnPixelsType<uint8_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<int8_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<uint16_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<int16_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<uint32_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<int32_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<uint64_t>(Slice, bool);
+    template long int Raster::countBitmapOnPixelsType<int64_t>(Slice, bool);
     template long int Raster::countBitmapOnPixelsType<float>(Slice, bool);
     template long int Raster::countBitmapOnPixelsType<double>(Slice, bool);
 
     template Raster* Raster::bitmapType<uint8_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<int8_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<uint16_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<int16_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<uint32_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<int32_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<uint64_t>(Raster*, RasterFunction*);
+    template Raster* Raster::bitmapType<int64_t>(Raster*, RasterFunction*);
     template Raster* Raster::bitmapType<float>(Raster*, RasterFunction*);
     template Raster* Raster::bitmapType<double>(Raster*, RasterFunction*);
     
     template Raster* Raster::copyUnderBitmapType<uint8_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<int8_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<uint16_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<int16_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<uint32_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<int32_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<uint64_t>(Raster*, Raster*);
+    template Raster* Raster::copyUnderBitmapType<int64_t>(Raster*, Raster*);
     template Raster* Raster::copyUnderBitmapType<float>(Raster*, Raster*);
     template Raster* Raster::copyUnderBitmapType<double>(Raster*, Raster*);
 
@@ -0,0 +1,343 @@
+// Raster_block.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <array>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+
+#include "H5Cpp.h"
+
+#include "Image.hpp"
+#include "Raster.hpp"
+#include "Slice.hpp"
+#include "WarpParameters.hpp"
+#include "TileIO.hpp"
+#include "Exceptions.hpp"
+#include "attributes.hpp"
+
+namespace GeoStar {
+
+    const long int Raster::BLOCK_PIXEL_BUDGET;
+
+
+    std::vector<Slice> Raster::blockSlices(const Slice &region) const {
+        Slice in = region;
+        std::vector<Slice> blocks;
+        if (in.getDeltaX() <= 0 || in.getDeltaY() <= 0) return blocks;
+
+        // block size: whole chunks if chunked, whole rows if contiguous:
+        long int blockX, blockY;
+        long int chunkX, chunkY;
+        if (chunkSize(chunkX, chunkY)) {
+            blockY = chunkY;
+            blockX = chunkX * std::max(1L, BLOCK_PIXEL_BUDGET / (chunkX*chunkY));
+        } else {
+            blockX = get_nx();
+            blockY = std::max(1L, BLOCK_PIXEL_BUDGET / blockX);
+        }
+
+        // block boundaries are multiples of the block size, in raster coordinates, so every
+        //  block (except at the region edges) covers whole chunks:
+        long int xEnd = in.getX0() + in.getDeltaX();
+        long int yEnd = in.getY0() + in.getDeltaY();
+        for (long int y = in.getY0(); y < yEnd; ) {
+            long int yNext = std::min(yEnd, (y/blockY + 1)*blockY);
+            for (long int x = in.getX0(); x < xEnd; ) {
+                long int xNext = std::min(xEnd, (x/blockX + 1)*blockX);
+                blocks.push_back(Slice(x, y, xNext-x, yNext-y));
+                x = xNext;
+            }// endfor: x
+            y = yNext;
+        }// endfor: y
+        return blocks;
+    }// end: blockSlices
+
+
+
+    template <typename T>
+    void Raster::blockEngine(const Slice &region, const std::vector<const Raster*> &others, Raster *rasOut,
+                             const std::function<void(const Slice&, std::vector<std::vector<T> >&)> &kernel) const {
+        std::vector<Slice> blocks = blockSlices(region);
+        if (blocks.size() == 0) return;
+
+        // all the inputs: this raster first, then the others:
+        std::vector<const Raster*> inputs(1, this);
+        inputs.insert(inputs.end(), others.begin(), others.end());
+
+        // two sets of buffers: one being computed, the other being written/read by the I/O thread
+        std::vector<std::vector<T> > buffers[2];
+        buffers[0].resize(inputs.size());
+        buffers[1].resize(inputs.size());
+
+        auto readBlock = [&](const Slice &block, std::vector<std::vector<T> > &data) {
+            Slice b = block;
+            for (size_t k = 0; k < inputs.size(); k++) {
+                data[k].resize(b.getDeltaX()*b.getDeltaY());
+                inputs[k]->read(block, &data[k][0]);
+            }
+        };
+
+        readBlock(blocks[0], buffers[0]);
+
+        for (size_t n = 0; n < blocks.size(); n++) {
+            std::vector<std::vector<T> > &current = buffers[n%2];
+            std::vector<std::vector<T> > &other = buffers[(n+1)%2];
+
+            // I/O thread: write block n-1 behind, then prefetch block n+1, into the idle buffers.
+            // All HDF5 calls are made by this one task, never concurrently with each other.
+            std::future<void> io = std::async(std::launch::async, [&, n]() {
+                if (rasOut && n > 0) rasOut->write(blocks[n-1], &other[0][0]);
+                if (n+1 < blocks.size()) readBlock(blocks[n+1], other);
+            });
+
+            // compute block n, while the I/O thread works:
+            try {
+                kernel(blocks[n], current);
+            } catch (...) {
+                io.wait();
+                throw;
+            }
+            io.get();   // rethrows any read/write error
+        }// endfor: blocks
+
+        // the last block has no next iteration to write it behind:
+        if (rasOut) rasOut->write(blocks.back(), &buffers[(blocks.size()-1)%2][0][0]);
+    }// end: blockEngine
+
+
+
+    template <typename T>
+    void Raster::parallelBlocks(const std::vector<Slice> &blocks, Raster *outRaster, const int &threads,
+                                const std::function<bool(const Slice&, std::vector<T>&, std::mutex&)> &compute) const {
+        int nthreads = (threads > 0) ? threads : (int)std::max(1u, std::thread::hardware_concurrency());
+        nthreads = (int)std::min((size_t)nthreads, blocks.size());
+        std::mutex io;     // one HDF5 call at a time (the library may not be thread-safe)
+
+        if (nthreads <= 1) {
+            std::vector<T> data;
+            // (a block computed as written, but left empty, has nothing to write)
+            for (size_t b = 0; b < blocks.size(); b++) {
+                data.clear();
+                if (compute(blocks[b], data, io) && !data.empty()) outRaster->write(blocks[b], data.data());
+            }// endfor: b
+            return;
+        }
+
+        // the blocks are handed out in order; each finished block waits in results until the writer
+        //  (this thread) gets to it.  Workers stop taking blocks more than 'window' ahead of it.
+        const size_t window = 2 * nthreads;
+        std::mutex mutex;
+        std::condition_variable ready;      // a block is finished (or a worker failed)
+        std::condition_variable room;       // the writer moved on (or failed)
+        size_t nextBlock = 0, nextWrite = 0;
+        std::vector<std::vector<T> > results(blocks.size());
+        std::vector<char> state(blocks.size(), 0);     // 0: not done, 1: write it, 2: skip it
+        std::exception_ptr error;
+
+        auto fail = [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+            ready.notify_all();
+            room.notify_all();
+        };
+
+        auto worker = [&]() {
+            for (;;) {
+                size_t b;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    room.wait(lock, [&]() {
+                        return error || nextBlock >= blocks.size() || nextBlock < nextWrite + window;
+                    });
+                    if (error || nextBlock >= blocks.size()) return;
+                    b = nextBlock++;
+                }
+                std::vector<T> data;
+                bool write;
+                try {
+                    write = compute(blocks[b], data, io);
+                } catch (...) {
+                    fail();
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results[b].swap(data);
+                    state[b] = write ? 1 : 2;
+                }
+                ready.notify_all();
+            }// endfor
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 0; t < nthreads; t++) pool.push_back(std::thread(worker));
+
+        // the ordered writer:
+        for (size_t w = 0; w < blocks.size(); w++) {
+            std::vector<T> data;
+            char s;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&]() { return error || state[w] != 0; });
+                if (error) break;
+                data.swap(results[w]);
+                s = state[w];
+                nextWrite = w + 1;
+            }
+            room.notify_all();
+            if (s != 1 || data.empty()) continue;
+            try {
+                std::lock_guard<std::mutex> lock(io);
+                outRaster->write(blocks[w], data.data());
+            } catch (...) {
+                fail();
+                break;
+            }
+        }// endfor: w
+
+        for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+        if (error) std::rethrow_exception(error);
+    }// end: parallelBlocks
+
+
+
+    template <typename T>
+    void Raster::forEachBlock(const std::function<void(const Slice&, const std::vector<T>&)> &kernel) const {
+        Slice region(0,0,get_nx(),get_ny());
+        forEachBlock<T>(region, kernel);
+    }
+
+
+    template <typename T>
+    void Raster::forEachBlock(const Slice &region, const std::function<void(const Slice&, const std::vector<T>&)> &kernel) const {
+        std::vector<const Raster*> others;
+        blockEngine<T>(region, others, 0, [&](const Slice &block, std::vector<std::vector<T> > &data) {
+            kernel(block, data[0]);
+        });
+    }
+
+
+    template <typename T>
+    void Raster::forEachBlock(Raster *rasOut, const std::function<void(const Slice&, std::vector<T>&)> &kernel) const {
+        Slice region(0,0,get_nx(),get_ny());
+        forEachBlock<T>(region, rasOut, kernel);
+    }
+
+
+    template <typename T>
+    void Raster::forEachBlock(const Slice &region, Raster *rasOut,
+                              const std::function<void(const Slice&, std::vector<T>&)> &kernel) const {
+        Slice in = region;
+        if (rasOut->get_nx() < in.getX0()+in.getDeltaX() || rasOut->get_ny() < in.getY0()+in.getDeltaY())
+            throw_RasterSizeError("in forEachBlock");
+
+        std::vector<const Raster*> others;
+        blockEngine<T>(region, others, rasOut, [&](const Slice &block, std::vector<std::vector<T> > &data) {
+            kernel(block, data[0]);
+        });
+    }
+
+
+    template <typename T>
+    void Raster::forEachBlock(const Raster *other, Raster *rasOut,
+                              const std::function<void(const Slice&, std::vector<T>&, const std::vector<T>&)> &kernel) const {
+        long int nx = get_nx(), ny = get_ny();
+        if (nx != other->get_nx() || ny != other->get_ny()) throw_RasterSizeError("in forEachBlock");
+        if (rasOut->get_nx() < nx || rasOut->get_ny() < ny) throw_RasterSizeError("in forEachBlock");
+
+        Slice region(0,0,nx,ny);
+        std::vector<const Raster*> others(1, other);
+        blockEngine<T>(region, others, rasOut, [&](const Slice &block, std::vector<std::vector<T> > &data) {
+            kernel(block, data[0], data[1]);
+        });
+    }
+
+
+
+    template void Raster::forEachBlock<uint8_t>(const std::function<void(const Slice&, const std::vector<uint8_t>&)>&) const;
+    template void Raster::forEachBlock<int8_t>(const std::function<void(const Slice&, const std::vector<int8_t>&)>&) const;
+    template void Raster::forEachBlock<uint16_t>(const std::function<void(const Slice&, const std::vector<uint16_t>&)>&) const;
+    template void Raster::forEachBlock<int16_t>(const std::function<void(const Slice&, const std::vector<int16_t>&)>&) const;
+    template void Raster::forEachBlock<uint32_t>(const std::function<void(const Slice&, const std::vector<uint32_t>&)>&) const;
+    template void Raster::forEachBlock<int32_t>(const std::function<void(const Slice&, const std::vector<int32_t>&)>&) const;
+    template void Raster::forEachBlock<uint64_t>(const std::function<void(const Slice&, const std::vector<uint64_t>&)>&) const;
+    template void Raster::forEachBlock<int64_t>(const std::function<void(const Slice&, const std::vector<int64_t>&)>&) const;
+    template void Raster::forEachBlock<float>(const std::function<void(const Slice&, const std::vector<float>&)>&) const;
+    template void Raster::forEachBlock<double>(const std::function<void(const Slice&, const std::vector<double>&)>&) const;
+
+    template void Raster::forEachBlock<uint8_t>(const Slice&, const std::function<void(const Slice&, const std::vector<uint8_t>&)>&) const;
+    template void Raster::forEachBlock<int8_t>(const Slice&, const std::function<void(const Slice&, const std::vector<int8_t>&)>&) const;
+    template void Raster::forEachBlock<uint16_t>(const Slice&, const std::function<void(const Slice&, const std::vector<uint16_t>&)>&) const;
+    template void Raster::forEachBlock<int16_t>(const Slice&, const std::function<void(const Slice&, const std::vector<int16_t>&)>&) const;
+    template void Raster::forEachBlock<uint32_t>(const Slice&, const std::function<void(const Slice&, const std::vector<uint32_t>&)>&) const;
+    template void Raster::forEachBlock<int32_t>(const Slice&, const std::function<void(const Slice&, const std::vector<int32_t>&)>&) const;
+    template void Raster::forEachBlock<uint64_t>(const Slice&, const std::function<void(const Slice&, const std::vector<uint64_t>&)>&) const;
+    template void Raster::forEachBlock<int64_t>(const Slice&, const std::function<void(const Slice&, const std::vector<int64_t>&)>&) const;
+    template void Raster::forEachBlock<float>(const Slice&, const std::function<void(const Slice&, const std::vector<float>&)>&) const;
+    template void Raster::forEachBlock<double>(const Slice&, const std::function<void(const Slice&, const std::vector<double>&)>&) const;
+
+    template void Raster::forEachBlock<uint8_t>(Raster*, const std::function<void(const Slice&, std::vector<uint8_t>&)>&) const;
+    template void Raster::forEachBlock<int8_t>(Raster*, const std::function<void(const Slice&, std::vector<int8_t>&)>&) const;
+    template void Raster::forEachBlock<uint16_t>(Raster*, const std::function<void(const Slice&, std::vector<uint16_t>&)>&) const;
+    template void Raster::forEachBlock<int16_t>(Raster*, const std::function<void(const Slice&, std::vector<int16_t>&)>&) const;
+    template void Raster::forEachBlock<uint32_t>(Raster*, const std::function<void(const Slice&, std::vector<uint32_t>&)>&) const;
+    template void Raster::forEachBlock<int32_t>(Raster*, const std::function<void(const Slice&, std::vector<int32_t>&)>&) const;
+    template void Raster::forEachBlock<uint64_t>(Raster*, const std::function<void(const Slice&, std::vector<uint64_t>&)>&) const;
+    template void Raster::forEachBlock<int64_t>(Raster*, const std::function<void(const Slice&, std::vector<int64_t>&)>&) const;
+    template void Raster::forEachBlock<float>(Raster*, const std::function<void(const Slice&, std::vector<float>&)>&) const;
+    template void Raster::forEachBlock<double>(Raster*, const std::function<void(const Slice&, std::vector<double>&)>&) const;
+
+    template void Raster::forEachBlock<uint8_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<uint8_t>&)>&) const;
+    template void Raster::forEachBlock<int8_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<int8_t>&)>&) const;
+    template void Raster::forEachBlock<uint16_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<uint16_t>&)>&) const;
+    template void Raster::forEachBlock<int16_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<int16_t>&)>&) const;
+    template void Raster::forEachBlock<uint32_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<uint32_t>&)>&) const;
+    template void Raster::forEachBlock<int32_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<int32_t>&)>&) const;
+    template void Raster::forEachBlock<uint64_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<uint64_t>&)>&) const;
+    template void Raster::forEachBlock<int64_t>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<int64_t>&)>&) const;
+    template void Raster::forEachBlock<float>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<float>&)>&) const;
+    template void Raster::forEachBlock<double>(const Slice&, Raster*, const std::function<void(const Slice&, std::vector<double>&)>&) const;
+
+    template void Raster::forEachBlock<uint8_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<uint8_t>&, const std::vector<uint8_t>&)>&) const;
+    template void Raster::forEachBlock<int8_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<int8_t>&, const std::vector<int8_t>&)>&) const;
+    template void Raster::forEachBlock<uint16_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<uint16_t>&, const std::vector<uint16_t>&)>&) const;
+    template void Raster::forEachBlock<int16_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<int16_t>&, const std::vector<int16_t>&)>&) const;
+    template void Raster::forEachBlock<uint32_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<uint32_t>&, const std::vector<uint32_t>&)>&) const;
+    template void Raster::forEachBlock<int32_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<int32_t>&, const std::vector<int32_t>&)>&) const;
+    template void Raster::forEachBlock<uint64_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<uint64_t>&, const std::vector<uint64_t>&)>&) const;
+    template void Raster::forEachBlock<int64_t>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<int64_t>&, const std::vector<int64_t>&)>&) const;
+    template void Raster::forEachBlock<float>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<float>&, const std::vector<float>&)>&) const;
+    template void Raster::forEachBlock<double>(const Raster*, Raster*, const std::function<void(const Slice&, std::vector<double>&, const std::vector<double>&)>&) const;
+
+    template void Raster::parallelBlocks<uint8_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<uint8_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<int8_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<int8_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<uint16_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<uint16_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<int16_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<int16_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<uint32_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<uint32_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<int32_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<int32_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<uint64_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<uint64_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<int64_t>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<int64_t>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<float>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<float>&, std::mutex&)>&) const;
+    template void Raster::parallelBlocks<double>(const std::vector<Slice>&, Raster*, const int&,
+                                           const std::function<bool(const Slice&, std::vector<double>&, std::mutex&)>&) const;
+
+}// end namespace GeoStar
@@ -0,0 +1,145 @@
+// Raster_block.hpp
+//
+//----------------------------------------
+
+/** \brief Raster -- Implementation of raster operations for HDF5-based GeoStar files.
+
+
+This class is used as the standard interface for raster operations
+ that are used for storing and processing of data in GeoStar using the HDF5 implementation.
+In particular, first, data is imported into GeoStar from data provided by a remote sensing data
+processing facility, or the output from another data processing system.
+This data is stored in the GeoStar file format.
+
+\see File, Image, Raster, RasterType, Slice, WarpParameters, TileIO
+
+\par Usage Overview
+The Raster class is meant to be used when dealing with GeoStar files.
+Other classes are used to deal with external files in other formats.
+This class provides methods for reading and writing rasters, as well as scaling and warping them.
+
+Reading a raster requires a slice object, which describes the rectangular portion of the raster to read,
+along with a templated vector buffer, to write the data into.
+
+Writing a raster requires a slice object, which describes the rectangular portion of the raster to write
+into, along with a templated vector buffer from which to write the data.
+
+Scaling a raster is possible using several different approaches.  The scale functions return a new Raster
+object, which contains the scaled data from the calling Raster.  See scale function documentation for
+more details.
+
+Warping a raster is possible using several different approaches.  The warp functions return a new Raster
+object, which contains the warped data from the calling Raster.  See warp function documentation for
+more details.
+ 
+Rotating a raster is possible using two different methods, "rotate" and "rotateWithWarp".  Currently "rotate" is
+preferred, as it is faster; "rotateWithWarp" is left in as a legacy function, for possible future testing.  For the
+simple "rotate" function, there are two approaches.  See rotate function documentation for more details.
+
+\par Details
+This class also has functions to display the raster width and height, and get and set functions for the
+raster type.
+
+The class keeps track of the rastername, in case that is needed.
+
+The constructors should only be called by the Image class: Image::createRaster.
+
+*/
+
+
+
+  private:
+      // largest number of pixels held in one block buffer (per input raster, per buffer)
+      static const long int BLOCK_PIXEL_BUDGET = 1048576;
+
+      // split 'region' into blocks aligned on this raster's chunk grid (or on whole rows,
+      //  for contiguous rasters), in row-major order.
+      std::vector<Slice> blockSlices(const Slice &region) const;
+
+      // the engine behind all the forEachBlock variants:  reads the same block of this raster
+      //  and of every raster in 'others' into data[0], data[1], ..., calls 'kernel', and, if
+      //  rasOut is given, writes data[0] back to rasOut at the same location.
+      template <typename T>
+      void blockEngine(const Slice &region, const std::vector<const Raster*> &others, Raster *rasOut,
+                       const std::function<void(const Slice&, std::vector<std::vector<T> >&)> &kernel) const;
+
+      // the parallel executor behind the geometric transforms (warp, rotate, flip, reproject):
+      //  'compute' fills the pixels of an output block (locking 'io' around any HDF5 call) and
+      //  returns whether the block is to be written (a block left empty is not).  It runs on 'threads' worker threads (0: one
+      //  per core), while this thread writes the finished blocks to outRaster, in order; at most
+      //  2*threads blocks are held at a time.  With threads == 1, all is done in this thread.
+      template <typename T>
+      void parallelBlocks(const std::vector<Slice> &blocks, Raster *outRaster, const int &threads,
+                          const std::function<bool(const Slice&, std::vector<T>&, std::mutex&)> &compute) const;
+
+  public:
+
+  /** \brief Raster::forEachBlock runs a function over every block of this raster, with I/O overlapped.
+
+   Raster::forEachBlock walks this raster (or a rectangular region of it) in blocks that are
+   aligned on the raster's HDF5 chunks, and calls the given function once per block with the
+   block's pixels.  While the function computes block N, block N+1 is read in, and block N-1 is
+   written out, on a background I/O thread; so reading, computing and writing all overlap.
+
+   There are three forms:
+   - read-only: the function gets (block, const data), and nothing is written.
+   - in/out: the function gets (block, data), may modify data, and data is written to rasOut
+     at the same location.  rasOut may be this raster, for in-place operations.
+   - two inputs: the function gets (block, data, otherData), where otherData is the same
+     block of the "other" raster, and data is written to rasOut.
+
+   \see Raster, Slice, RasterLayout
+
+   \param[in] region
+       Optional rectangular region of this raster to process; defaults to the whole raster.
+   \param[in] other
+       The second input raster, which must be the same size as this raster.
+   \param[in] rasOut
+       The raster to write each processed block to.  It must be at least as big as this raster.
+   \param[in] kernel
+       The function to call for each block.  The data is row-major: pixel (x,y) of the block is
+       data[(y-block.getY0())*block.getDeltaX() + (x-block.getX0())].
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterReadError
+       RasterWriteError
+       RasterSizeError
+       Any exception thrown by the kernel.
+
+   \par Example
+       Clip all negative pixels of "ras" to 0, in place:
+       \code
+       ras->forEachBlock<float>(ras, [](const GeoStar::Slice &block, std::vector<float> &data) {
+           for (size_t i = 0; i < data.size(); i++)
+               if (data[i] < 0) data[i] = 0;
+       });
+       \endcode
+
+   \par Details
+       The template type T must be given explicitly; pixels are converted to T by HDF5 when read,
+       and back to the output raster's type when written.
+       The kernel runs on the calling thread, while HDF5 runs on the I/O thread, so the kernel
+       must not call any HDF5 (Raster/Image/File) functions itself.
+  */
+      template <typename T>
+      void forEachBlock(const std::function<void(const Slice&, const std::vector<T>&)> &kernel) const;
+
+      template <typename T>
+      void forEachBlock(const Slice &region, const std::function<void(const Slice&, const std::vector<T>&)> &kernel) const;
+
+      template <typename T>
+      void forEachBlock(Raster *rasOut, const std::function<void(const Slice&, std::vector<T>&)> &kernel) const;
+
+      template <typename T>
+      void forEachBlock(const Slice &region, Raster *rasOut,
+                        const std::function<void(const Slice&, std::vector<T>&)> &kernel) const;
+
+      template <typename T>
+      void forEachBlock(const Raster *other, Raster *rasOut,
+                        const std::function<void(const Slice&, std::vector<T>&, const std::vector<T>&)> &kernel) const;
+
+
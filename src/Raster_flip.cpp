@@ -9,6 +9,8 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <mutex>
 
 #include "H5Cpp.h"
 
@@ -25,7 +27,7 @@ namespace GeoStar {
     
 
     
-    Raster* Raster::flip(const std::string &newRasterName, short flipAxis) {
+    Raster* Raster::flip(const std::string &newRasterName, short flipAxis, const int threads) {
         if (flipAxis == Raster::FLIP_HORIZONTALLY ||
             flipAxis == Raster::FLIP_VERTICALLY ||
             flipAxis == Raster::FLIP_BOTH) {
@@ -38,7 +40,7 @@ namespace GeoStar {
             } catch (RasterExistsException e) {
                 rasNew = image->open_raster(newRasterName);
             }
-            return flip(rasNew, flipAxis);
+            return flip(rasNew, flipAxis, threads);
         } else {
             throw_FlipOptionError(std::to_string(flipAxis));
         }
@@ -46,7 +48,7 @@ namespace GeoStar {
     }
     
     
-    Raster* Raster::flip(Raster *rasNew, short flipAxis) {
+    Raster* Raster::flip(Raster *rasNew, short flipAxis, const int threads) {
         if (flipAxis == Raster::FLIP_HORIZONTALLY ||
             flipAxis == Raster::FLIP_VERTICALLY ||
             flipAxis == Raster::FLIP_BOTH) {
@@ -56,35 +58,10 @@ namespace GeoStar {
             
             
             // Now, call the templated flipType<>() method, based on the new raster type:
-            switch(raster_datatype) {
-                case INT8U:
-                    return flipType<uint8_t>(rasNew, flipAxis);
-                    /*
-                     case INT8S:
-                     return flipType<int8_t>(rasNew, flipAxis);
-                     case INT16U:
-                     return flipType<uint16_t>(rasNew, flipAxis);
-                     case INT16S:
-                     return flipType<int16_t>(rasNew, flipAxis);
-                     case INT32U:
-                     return flipType<uint32_t>(rasNew, flipAxis);
-                     case INT32S:
-                     return flipType<int32_t>(rasNew, flipAxis);
-                     case INT64U:
-                     return flipType<uint64_t>(rasNew, flipAxis);
-                     case INT64S:
-                     return flipType<int64_t>(rasNew, flipAxis);
-                     */
-                case REAL32:
-                    return flipType<float>(rasNew, flipAxis);
-                    
-                case REAL64:
-                    return flipType<double>(rasNew, flipAxis);
-                    //case COMPLEX_INT16:
-                    //    return
-                default:
-                    throw_RasterUnsupportedTypeError(fullRastername);
-            }
+            return visitRasterType(raster_datatype, [&](auto tag) {
+                typedef typename decltype(tag)::type T;
+                return flipType<T>(rasNew, flipAxis, threads);
+            }, fullRastername);
         } else {
             throw_FlipOptionError(std::to_string(flipAxis));
         }
@@ -95,84 +72,59 @@ namespace GeoStar {
     
     
     template <typename T>
-    Raster* Raster::flipType(Raster *outRaster, const int flipAxis) {
+    Raster* Raster::flipType(Raster *outRaster, const int flipAxis, const int threads) {
         
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        GeoStar::Slice tileDescriptor(0,0,8,8);
-        int maxNumberSlicesInRam = 70;
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
-        
-        GeoStar::Slice scalingSlice(0,0,2,2,4);
-        
-        GeoStar::Raster *rasNew = outRaster;
+
         long int nx = get_nx();
         long int ny = get_ny();
-        long int xIn0 = 0;   //in.getX0();   ... for Slice in;
-        long int yIn0 = 0;   //in.getY0();
-        long int xInMax = nx - 1;       //xIn0 + in.getDeltaX();
-        long int yInMax = ny - 1;       //yIn0 + in.getDeltaY();
-        
-        long int newNy = ny;      //sliceOut.getDeltaY();
-        long int newNx = nx;      //sliceOut.getDeltaX();
-        long int xOut0 = 0;                  //sliceOut.getX0();
-        long int yOut0 = 0;                  //sliceOut.getY0();
-        long int xOutMax = newNx - 1;        //xOut0 + newDeltaX;
-        long int yOutMax = newNy - 1;        //yOut0 + newDeltaY;
-        std::vector<T> newData(newNx);    // this will hold ONE ROW of the new image - output slice
-        long int oldY, oldX;
-        T pixelVal;
-        
-        GeoStar::Point pt;    // pt.x and pt.y are double
-        double yVal, xVal;
-        
-        // MAY want to pass in sliceInput/sliceOut LATER ... and use as in above comments.
-        Slice sliceInput(0,0,nx,ny);
-        Slice sliceOut(0,0,newNx,newNy);
-        //sliceInput.setDeltaY(3);
-        sliceOut.setDeltaY(1);
-        
-        // NOTE: deltaX and deltaY are the wkt-coordinate differences for each pixel in this raster, for the
-        //       x- and y- directions.  And, newDeltaX and newDeltaY are the wkt-coordinate differences for this
-        //       newly created raster's pixels (with it's own different wkt).
-        //
-        double halfNX = (nx * 0.5) - 0.5;
-        double halfNY = (ny * 0.5) - 0.5;
-        
-        for (long int i = yOut0; i < yOutMax; i++) {
-            if (flipAxis == FLIP_HORIZONTALLY) oldY = i;
-            else {
-                yVal = static_cast<double>(i);
-                yVal = halfNY + (halfNY - yVal);
-                oldY = static_cast<long> (yVal);
+        bool flipX = (flipAxis == FLIP_HORIZONTALLY || flipAxis == FLIP_BOTH);
+        bool flipY = (flipAxis == FLIP_VERTICALLY || flipAxis == FLIP_BOTH);
+
+        // chunk caches for this access pattern (restored at the end): each block reads one window
+        ChunkCacheGuard inCache(this, windowCache());
+
+        // a block (chunk) of the output at a time: its pixels are the mirrored window of the input,
+        //  read at once and reversed in memory.
+        std::vector<Slice> blocks = outRaster->blockSlices(Slice(0,0,nx,ny));
+        parallelBlocks<T>(blocks, outRaster, threads, [&](const Slice &block, std::vector<T> &data, std::mutex &io) {
+            long int w = block.getDeltaX();
+            long int h = block.getDeltaY();
+            long int x0 = flipX ? nx - block.getX0() - w : block.getX0();
+            long int y0 = flipY ? ny - block.getY0() - h : block.getY0();
+            data.resize(w * h);
+            {
+                std::lock_guard<std::mutex> lock(io);
+                read(Slice(x0, y0, w, h), &data[0]);
             }
-            
-            for (long int j = xOut0; j < xOutMax; j++) {
-                if (flipAxis == FLIP_VERTICALLY) oldX = j;
-                else {
-                    xVal = static_cast<double>(j);
-                    xVal = halfNX + (halfNX - xVal);
-                    oldX = static_cast<long> (xVal);
-                }
-                pixelVal = getScaledPixelFromTile<T>(oldY, oldX, 0.0, 0.0, sliceInput, scalingSlice, reader);
-                
-                newData[j] = pixelVal;
+            if (flipX) {
+                for (long int r = 0; r < h; r++) std::reverse(data.begin() + r*w, data.begin() + (r+1)*w);
             }
-            sliceOut.setY0(i);
-            rasNew->write(sliceOut,newData);
-            
-        }
+            if (flipY) {
+                for (long int r = 0; r < h/2; r++)
+                    std::swap_ranges(data.begin() + r*w, data.begin() + (r+1)*w, data.begin() + (h-1-r)*w);
+            }
+            return true;
+        });
         
         std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
-        std::cout << "transform execution duration: " << duration << std::endl;
+        std::cout << "flip execution duration: " << duration << std::endl;
         
-        return rasNew;
+        return outRaster;
     }
     
     
-    template Raster* Raster::flipType<uint8_t>(Raster*, const int);
-    template Raster* Raster::flipType<float>(Raster*, const int);
-    template Raster* Raster::flipType<double>(Raster*, const int);
+    template Raster* Raster::flipType<uint8_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<int8_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<uint16_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<int16_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<uint32_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<int32_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<uint64_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<int64_t>(Raster*, const int, const int);
+    template Raster* Raster::flipType<float>(Raster*, const int, const int);
+    template Raster* Raster::flipType<double>(Raster*, const int, const int);
 
 
 }// end namespace GeoStar
@@ -52,7 +52,7 @@ The constructors should only be called by the Image class: Image::createRaster.
   private:
 
       template <typename T>
-      Raster* flipType(Raster *outRaster, const int flipAxis);
+      Raster* flipType(Raster *outRaster, const int flipAxis, const int threads = 1);
       
 
   public:
@@ -60,8 +60,9 @@ The constructors should only be called by the Image class: Image::createRaster.
       static const short FLIP_VERTICALLY = 2;
       static const short FLIP_BOTH = 3;
 
-      // return a new raster, which has been flipped from this raster, either horizontally, vertically, or both:
-      Raster* flip(const std::string &newRasterName, short flipAxis);
-      Raster* flip(Raster *outRaster, short flipAxis);
+      // return a new raster, which has been flipped from this raster, either horizontally, vertically, or both.
+      //  threads: the number of threads computing output blocks (0: one per core)
+      Raster* flip(const std::string &newRasterName, short flipAxis, const int threads = 1);
+      Raster* flip(Raster *outRaster, short flipAxis, const int threads = 1);
       
 
@@ -50,15 +50,19 @@ The constructors should only be called by the Image class: Image::createRaster.
 
 
   private:
+      // the smallest/largest pixel of the slice, in the raster's own type T (the largest/smallest
+      //  value of T for an empty slice)
       template <typename T>
-      uint8_t minPixelType(Slice in, bool isUnsigned);
+      T minPixelType(Slice in);
       template <typename T>
-      uint8_t maxPixelType(Slice in, bool isUnsigned);
+      T maxPixelType(Slice in);
 
   public:
-      uint8_t minPixel();
-      uint8_t minPixel(Slice in);
-      uint8_t maxPixel();
-      uint8_t maxPixel(Slice in);
+      // the smallest/largest pixel of the raster (or of the slice), for any pixel type.  NaN
+      //  pixels are skipped.  (Integers beyond 2^53 are rounded to the nearest double.)
+      double minPixel();
+      double minPixel(Slice in);
+      double maxPixel();
+      double maxPixel(Slice in);
 
 
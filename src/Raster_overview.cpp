@@ -0,0 +1,274 @@
+// Raster_overview.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "H5Cpp.h"
+
+#include "Image.hpp"
+#include "Raster.hpp"
+#include "Slice.hpp"
+#include "WarpParameters.hpp"
+#include "TileIO.hpp"
+#include "Exceptions.hpp"
+#include "attributes.hpp"
+
+namespace GeoStar {
+
+    std::string Raster::overviewName(const int level) const {
+        // the bands of a band stack share a dataset name, so their overviews carry the band:
+        if (band >= 0) return rastername + "_band" + std::to_string(band) + "_overview_" + std::to_string(level);
+        return rastername + "_overview_" + std::to_string(level);
+    }
+
+
+
+    std::string Raster::overviewLevelsAttribute() const {
+        // ... and so do the level lists, which are on the shared dataset:
+        if (band >= 0) return "overviews_band" + std::to_string(band);
+        return "overviews";
+    }
+
+
+
+    void Raster::buildOverviews(const std::vector<int> &levels, const int method) {
+        if (method != Raster::OVERVIEW_AVERAGE &&
+            method != Raster::OVERVIEW_NEAREST &&
+            method != Raster::OVERVIEW_MODE) {
+            throw_OverviewOptionError("method " + std::to_string(method));
+        }
+
+        std::vector<int> sortedLevels = levels;
+        std::sort(sortedLevels.begin(), sortedLevels.end());
+        sortedLevels.erase(std::unique(sortedLevels.begin(), sortedLevels.end()), sortedLevels.end());
+        if (sortedLevels.empty()) return;
+
+        // every level must divide the largest, so one band of maxLevel rows holds whole
+        //  overview rows for all of the levels:
+        int maxLevel = sortedLevels.back();
+        for (size_t k = 0; k < sortedLevels.size(); k++) {
+            if (sortedLevels[k] < 2 || maxLevel % sortedLevels[k] != 0)
+                throw_OverviewOptionError("level " + std::to_string(sortedLevels[k]));
+        }// endfor
+
+        // Now, call the templated buildOverviewsType<>() method, based on the raster type:
+        visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            buildOverviewsType<T>(sortedLevels, method);
+        }, fullRastername);
+    }// end: buildOverviews
+
+
+
+    std::vector<int> Raster::getOverviewLevels() const {
+        std::vector<int> levels;
+        std::string attrName = overviewLevelsAttribute();
+        if (!rasterobj->attrExists(attrName)) return levels;
+
+        std::stringstream ss(GeoStar::read_attribute(rasterobj, attrName));
+        int level;
+        while (ss >> level) levels.push_back(level);
+        return levels;
+    }// end: getOverviewLevels
+
+
+
+    template <typename T>
+    void Raster::buildOverviewsType(const std::vector<int> &levels, const int method) {
+        long int nx = get_nx();
+        long int ny = get_ny();
+        int maxLevel = levels.back();
+
+        // (re)create the overview rasters, with the georeferencing scaled to their pixel size:
+        bool hasLocation = rasterobj->attrExists("location") && getLocationAttributes();
+        std::vector<Raster*> overviews;
+        for (size_t k = 0; k < levels.size(); k++) {
+            int level = levels[k];
+            std::string name = overviewName(level);
+            if (image->datasetExists(name)) image->imageobj->unlink(name);
+            Raster *ov = image->create_raster(name, raster_datatype, (nx+level-1)/level, (ny+level-1)/level);
+            // tagged with the dataset it belongs to, so the Image does not take it for a channel:
+            GeoStar::write_attribute(ov->rasterobj, "overview_of", rastername);
+            if (hasLocation) ov->setLocationAttributes(x0, y0, deltaX*level, deltaY*level);
+            if (rasterobj->attrExists("wkt")) {
+                std::string wktValue = getWKT();
+                ov->setWKT(wktValue);
+            }
+            overviews.push_back(ov);
+        }// endfor
+
+        // one pass over this raster, in bands of maxLevel full rows; each band gives
+        //  maxLevel/L rows of overview L:
+        ChunkCacheGuard inCache(this, rowScanCache());
+        std::vector<T> band;
+        std::vector<T> out;
+        std::vector<T> block;         // the pixels of one LxL block, for the mode
+        block.reserve((size_t)maxLevel * maxLevel);
+
+        for (long int bandY0 = 0; bandY0 < ny; bandY0 += maxLevel) {
+            long int rows = std::min((long int)maxLevel, ny - bandY0);
+            read(Slice(0, bandY0, nx, rows), band);
+
+            for (size_t k = 0; k < levels.size(); k++) {
+                long int level = levels[k];
+                long int onx = (nx + level - 1) / level;
+                long int ony = (rows + level - 1) / level;
+                out.resize(onx * ony);
+
+                for (long int oy = 0; oy < ony; oy++) {
+                    long int by0 = oy * level;
+                    long int by1 = std::min(by0 + level, rows);
+                    for (long int ox = 0; ox < onx; ox++) {
+                        long int bx0 = ox * level;
+                        long int bx1 = std::min(bx0 + level, nx);
+                        T value;
+
+                        if (method == Raster::OVERVIEW_NEAREST) {
+                            // the pixel nearest the block's center:
+                            long int cx = std::min(bx0 + level/2, bx1 - 1);
+                            long int cy = std::min(by0 + level/2, by1 - 1);
+                            value = band[cy*nx + cx];
+
+                        } else if (method == Raster::OVERVIEW_MODE) {
+                            // most common value; sorted, so ties go to the smallest:
+                            block.clear();
+                            for (long int y = by0; y < by1; y++)
+                                block.insert(block.end(), band.begin() + y*nx + bx0, band.begin() + y*nx + bx1);
+                            std::sort(block.begin(), block.end());
+                            value = block[0];
+                            size_t bestRun = 0;
+                            for (size_t i = 0; i < block.size(); ) {
+                                size_t j = i;
+                                while (j < block.size() && block[j] == block[i]) j++;
+                                if (j - i > bestRun) {
+                                    bestRun = j - i;
+                                    value = block[i];
+                                }
+                                i = j;
+                            }// endfor
+
+                        } else {
+                            // the mean of the pixels in the (possibly partial, at the edges) block:
+                            double sum = 0.0;
+                            for (long int y = by0; y < by1; y++)
+                                for (long int x = bx0; x < bx1; x++)
+                                    sum += band[y*nx + x];
+                            double mean = sum / ((by1 - by0) * (bx1 - bx0));
+                            value = std::numeric_limits<T>::is_integer ? (T)std::floor(mean + 0.5) : (T)mean;
+                        }// endif
+                        out[oy*onx + ox] = value;
+                    }// endfor - ox
+                }// endfor - oy
+
+                overviews[k]->write(Slice(0, bandY0/level, onx, ony), out);
+            }// endfor - levels
+        }// endfor - bands
+        inCache.restore();
+
+        std::string levelList;
+        for (size_t k = 0; k < levels.size(); k++) {
+            if (k > 0) levelList += " ";
+            levelList += std::to_string(levels[k]);
+            delete overviews[k];
+        }// endfor
+        GeoStar::write_attribute(rasterobj, overviewLevelsAttribute(), levelList);
+    }// end: buildOverviewsType
+
+
+
+    template <typename T>
+    int Raster::readOverview(const Slice &inSlice, const long int &outNx, const long int &outNy,
+                             std::vector<T> &buffer) const {
+        long int dx = inSlice.getDeltaX();
+        long int dy = inSlice.getDeltaY();
+        if (outNx <= 0 || outNy <= 0 || dx <= 0 || dy <= 0) throw_RasterSizeError("in readOverview");
+
+        // the coarsest overview with at least the requested resolution:
+        double factor = std::min((double)dx / outNx, (double)dy / outNy);
+        int level = 1;
+        std::vector<int> levels = getOverviewLevels();
+        for (size_t k = 0; k < levels.size(); k++) {
+            if (levels[k] <= factor && levels[k] > level && image->datasetExists(overviewName(levels[k])))
+                level = levels[k];
+        }// endfor
+
+        Raster *ov = NULL;
+        const Raster *src = this;
+        if (level > 1) {
+            ov = new Raster(image, overviewName(level));
+            src = ov;
+        }
+
+        // the region in the source's pixels; any reduction left over is done with a strided
+        //  (decimated) read, so only about outNx*outNy pixels are read either way:
+        long int srcNx = src->get_nx();
+        long int srcNy = src->get_ny();
+        long int sx0 = std::max(0L, inSlice.getX0() / level);
+        long int sy0 = std::max(0L, inSlice.getY0() / level);
+        long int sx1 = std::min(srcNx, (inSlice.getX0() + dx + level - 1) / level);
+        long int sy1 = std::min(srcNy, (inSlice.getY0() + dy + level - 1) / level);
+        if (sx1 <= sx0 || sy1 <= sy0) {
+            delete ov;
+            throw_RasterSizeError("in readOverview");
+        }
+        long int stride = std::max(1L, (long int)(factor / level));
+        Slice srcSlice(sx0, sy0, sx1 - sx0, sy1 - sy0, 0, stride, stride);
+        std::vector<T> region;
+        try {
+            src->read(srcSlice, region);
+        } catch (...) {
+            delete ov;
+            throw;
+        }
+        delete ov;
+
+        // nearest-pixel sampling to the exact output size:
+        long int cx = srcSlice.getCountX();
+        long int cy = srcSlice.getCountY();
+        buffer.resize(outNx * outNy);
+        std::vector<long int> column(outNx);
+        for (long int ox = 0; ox < outNx; ox++) {
+            double fx = inSlice.getX0() + (ox + 0.5) * dx / outNx;
+            long int ix = ((long int)(fx / level) - sx0) / stride;
+            column[ox] = std::max(0L, std::min(cx - 1, ix));
+        }// endfor
+        for (long int oy = 0; oy < outNy; oy++) {
+            double fy = inSlice.getY0() + (oy + 0.5) * dy / outNy;
+            long int iy = std::max(0L, std::min(cy - 1, ((long int)(fy / level) - sy0) / stride));
+            for (long int ox = 0; ox < outNx; ox++)
+                buffer[oy*outNx + ox] = region[iy*cx + column[ox]];
+        }// endfor
+        return level;
+    }// end: readOverview
+
+
+    template void Raster::buildOverviewsType<uint8_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<int8_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<uint16_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<int16_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<uint32_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<int32_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<uint64_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<int64_t>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<float>(const std::vector<int>&, const int);
+    template void Raster::buildOverviewsType<double>(const std::vector<int>&, const int);
+
+    template int Raster::readOverview<uint8_t>(const Slice&, const long int&, const long int&, std::vector<uint8_t>&) const;
+    template int Raster::readOverview<int8_t>(const Slice&, const long int&, const long int&, std::vector<int8_t>&) const;
+    template int Raster::readOverview<uint16_t>(const Slice&, const long int&, const long int&, std::vector<uint16_t>&) const;
+    template int Raster::readOverview<int16_t>(const Slice&, const long int&, const long int&, std::vector<int16_t>&) const;
+    template int Raster::readOverview<uint32_t>(const Slice&, const long int&, const long int&, std::vector<uint32_t>&) const;
+    template int Raster::readOverview<int32_t>(const Slice&, const long int&, const long int&, std::vector<int32_t>&) const;
+    template int Raster::readOverview<uint64_t>(const Slice&, const long int&, const long int&, std::vector<uint64_t>&) const;
+    template int Raster::readOverview<int64_t>(const Slice&, const long int&, const long int&, std::vector<int64_t>&) const;
+    template int Raster::readOverview<float>(const Slice&, const long int&, const long int&, std::vector<float>&) const;
+    template int Raster::readOverview<double>(const Slice&, const long int&, const long int&, std::vector<double>&) const;
+
+}// end namespace GeoStar
@@ -0,0 +1,148 @@
+// Raster_overview.hpp
+//
+//----------------------------------------
+
+/** \brief Raster -- Implementation of raster operations for HDF5-based GeoStar files.
+
+
+This class is used as the standard interface for raster operations
+ that are used for storing and processing of data in GeoStar using the HDF5 implementation.
+In particular, first, data is imported into GeoStar from data provided by a remote sensing data
+processing facility, or the output from another data processing system.
+This data is stored in the GeoStar file format.
+
+\see File, Image, Raster, RasterType, Slice, WarpParameters, TileIO
+
+\par Usage Overview
+The Raster class is meant to be used when dealing with GeoStar files.
+Other classes are used to deal with external files in other formats.
+This class provides methods for reading and writing rasters, as well as scaling and warping them.
+
+Reading a raster requires a slice object, which describes the rectangular portion of the raster to read,
+along with a templated vector buffer, to write the data into.
+
+Writing a raster requires a slice object, which describes the rectangular portion of the raster to write
+into, along with a templated vector buffer from which to write the data.
+
+Scaling a raster is possible using several different approaches.  The scale functions return a new Raster
+object, which contains the scaled data from the calling Raster.  See scale function documentation for
+more details.
+
+Warping a raster is possible using several different approaches.  The warp functions return a new Raster
+object, which contains the warped data from the calling Raster.  See warp function documentation for
+more details.
+ 
+Rotating a raster is possible using two different methods, "rotate" and "rotateWithWarp".  Currently "rotate" is
+preferred, as it is faster; "rotateWithWarp" is left in as a legacy function, for possible future testing.  For the
+simple "rotate" function, there are two approaches.  See rotate function documentation for more details.
+
+\par Details
+This class also has functions to display the raster width and height, and get and set functions for the
+raster type.
+
+The class keeps track of the rastername, in case that is needed.
+
+The constructors should only be called by the Image class: Image::createRaster.
+
+*/
+
+
+
+  private:
+
+      // name of the overview dataset for a reduction level, e.g. "ras1_overview_4"
+      std::string overviewName(const int level) const;
+
+      // the name of the attribute that lists the overview levels of this raster ("overviews", or
+      //  "overviews_band<k>" for band k of a band stack)
+      std::string overviewLevelsAttribute() const;
+
+      template <typename T>
+      void buildOverviewsType(const std::vector<int> &levels, const int method);
+
+
+  public:
+      static const short OVERVIEW_AVERAGE = 1;
+      static const short OVERVIEW_NEAREST = 2;
+      static const short OVERVIEW_MODE = 3;
+
+  /** \brief Raster::buildOverviews builds reduced-resolution copies ("overviews") of this raster.
+
+   Raster::buildOverviews makes, for each level L, a raster L times smaller in both directions, in the
+   same Image, so previews and coarse analyses can read a few pixels instead of the whole raster.
+   All the levels are built in one pass over this raster.
+
+   \see  readOverview, getOverviewLevels
+
+   \param[in] levels
+       The reduction factors, e.g. {2, 4, 8, 16}.  Each must be at least 2, and must divide the
+       largest one (powers of 2 always do).
+
+   \param[in] method
+       How each LxL block of pixels becomes one overview pixel:
+         OVERVIEW_AVERAGE: the mean (rounded, for integer rasters); best for continuous data.
+         OVERVIEW_NEAREST: the pixel nearest the block's center; fastest, keeps exact values.
+         OVERVIEW_MODE:    the most common value (smallest one on ties); for classified data.
+
+   \returns
+       nothing.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       OverviewOptionException
+       RasterReadError
+       RasterWriteError
+
+   \par Example
+       \code
+       ras->buildOverviews({2, 4, 8, 16}, GeoStar::Raster::OVERVIEW_AVERAGE);
+       std::vector<float> preview;
+       ras->readOverview(GeoStar::Slice(0,0,ras->get_nx(),ras->get_ny()), 1024, 1024, preview);
+       \endcode
+
+   \par Details
+       Overview L of raster "ras" is the raster "ras_overview_L", of size ceil(nx/L) X ceil(ny/L);
+       blocks at the right and bottom edges are averaged over the pixels they hold.  Its
+       "overview_of" attribute names "ras", so Image::getChannels leaves it out, and Image::copy_to
+       copies it along with "ras".
+       The levels are recorded in the "overviews" attribute of this raster.  Band k of a band stack
+       "ms" has its own overviews, "ms_band<k>_overview_L", and its own level list, in the
+       "overviews_band<k>" attribute of the stack's dataset.  Building again
+       replaces the old overviews; they are not updated when this raster is written.
+  */
+      void buildOverviews(const std::vector<int> &levels, const int method = OVERVIEW_AVERAGE);
+
+      // return the overview levels built for this raster (empty if none)
+      std::vector<int> getOverviewLevels() const;
+
+  /** \brief Raster::readOverview reads a region of this raster at a reduced resolution.
+
+   Raster::readOverview reads the region inSlice of this raster, resampled to outNx X outNy pixels,
+   from the coarsest overview that still has at least that resolution (or from this raster, if there
+   is none), so the I/O is proportional to the output size rather than to the region size.
+
+   \see  buildOverviews
+
+   \param[in] inSlice
+       The region of this raster, in full-resolution pixel coordinates.
+
+   \param[in] outNx, outNy
+       The size of the output, in pixels.
+
+   \param[out] buffer
+       The outNx*outNy output pixels, row-major; resized as needed.
+
+   \returns
+       The level that was read: 1 for this raster, or L for overview L.
+
+   \par Exceptions
+       Exceptions that may be raised by this method:
+       RasterReadError
+       RasterSizeError
+
+   \par Details
+       The overview region is read and then sampled (nearest pixel) to the exact output size.
+  */
+      template <typename T>
+      int readOverview(const Slice &inSlice, const long int &outNx, const long int &outNy,
+                       std::vector<T> &buffer) const;
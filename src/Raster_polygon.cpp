@@ -94,41 +94,10 @@ namespace GeoStar {
 
     //Vector* Raster::rasterToPolygon(Vector *vecNew) {
     void Raster::rasterToPolygon() {
-        switch(raster_datatype) {
-            case INT8U:
-                //return rasterToPolygonType<uint8_t>(vecNew);
-                rasterToPolygonType<uint8_t>();
-                break;
-                /*
-                 case INT8S:
-                 return rasterToPolygonType<int8_t>(vecNew,);
-                 case INT16U:
-                 return rasterToPolygonType<uint16_t>(vecNew);
-                 case INT16S:
-                 return rasterToPolygonType<int16_t>(vecNew);
-                 case INT32U:
-                 return rasterToPolygonType<uint32_t>(vecNew);
-                 case INT32S:
-                 return rasterToPolygonType<int32_t>(vecNew);
-                 case INT64U:
-                 return rasterToPolygonType<uint64_t>(vecNew);
-                 case INT64S:
-                 return rasterToPolygonType<int64_t>(vecNew);
-                 */
-            case REAL32:
-                //return rasterToPolygonType<float>(vecNew);
-                rasterToPolygonType<float>();
-                break;
-
-            case REAL64:
-                //return rasterToPolygonType<double>(vecNew);
-                rasterToPolygonType<double>();
-                break;
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            rasterToPolygonType<T>();
+        }, fullRastername);
     }
     
     
@@ -307,9 +276,8 @@ namespace GeoStar {
     void  Raster::rasterToPolygonType() {
         
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        GeoStar::Slice tileDescriptor(0,0,10,10);
-        int maxNumberSlicesInRam = 70;
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
+        // one output row at a time: tiles sized to the input's chunks, enough of them for a row sweep
+        GeoStar::TileIO<T> reader(this, get_nx(), 2);
         
         GeoStar::Slice scalingSlice(0,0,2,2,4);
 
@@ -613,41 +581,10 @@ namespace GeoStar {
     
     //Vector* Raster::rasterToPolygon(Vector *vecNew) {
     void Raster::OLDrasterToPolygon() {
-        switch(raster_datatype) {
-            case INT8U:
-                //return OLDrasterToPolygonType<uint8_t>(vecNew);
-                OLDrasterToPolygonType<uint8_t>();
-                break;
-                /*
-                 case INT8S:
-                 return OLDrasterToPolygonType<int8_t>(vecNew,);
-                 case INT16U:
-                 return OLDrasterToPolygonType<uint16_t>(vecNew);
-                 case INT16S:
-                 return OLDrasterToPolygonType<int16_t>(vecNew);
-                 case INT32U:
-                 return OLDrasterToPolygonType<uint32_t>(vecNew);
-                 case INT32S:
-                 return OLDrasterToPolygonType<int32_t>(vecNew);
-                 case INT64U:
-                 return OLDrasterToPolygonType<uint64_t>(vecNew);
-                 case INT64S:
-                 return OLDrasterToPolygonType<int64_t>(vecNew);
-                 */
-            case REAL32:
-                //return OLDrasterToPolygonType<float>(vecNew);
-                OLDrasterToPolygonType<float>();
-                break;
-                
-            case REAL64:
-                //return OLDrasterToPolygonType<double>(vecNew);
-                OLDrasterToPolygonType<double>();
-                break;
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            OLDrasterToPolygonType<T>();
+        }, fullRastername);
     }
     
     
@@ -809,10 +746,24 @@ namespace GeoStar {
     //template Vector* Raster::rasterToPolygonType<float>(Vector*);
     //template Vector* Raster::rasterToPolygonType<double>(Vector*);
     template void Raster::rasterToPolygonType<uint8_t>();
+    template void Raster::rasterToPolygonType<int8_t>();
+    template void Raster::rasterToPolygonType<uint16_t>();
+    template void Raster::rasterToPolygonType<int16_t>();
+    template void Raster::rasterToPolygonType<uint32_t>();
+    template void Raster::rasterToPolygonType<int32_t>();
+    template void Raster::rasterToPolygonType<uint64_t>();
+    template void Raster::rasterToPolygonType<int64_t>();
     template void Raster::rasterToPolygonType<float>();
     template void Raster::rasterToPolygonType<double>();
 
     template void Raster::OLDrasterToPolygonType<uint8_t>();
+    template void Raster::OLDrasterToPolygonType<int8_t>();
+    template void Raster::OLDrasterToPolygonType<uint16_t>();
+    template void Raster::OLDrasterToPolygonType<int16_t>();
+    template void Raster::OLDrasterToPolygonType<uint32_t>();
+    template void Raster::OLDrasterToPolygonType<int32_t>();
+    template void Raster::OLDrasterToPolygonType<uint64_t>();
+    template void Raster::OLDrasterToPolygonType<int64_t>();
     template void Raster::OLDrasterToPolygonType<float>();
     template void Raster::OLDrasterToPolygonType<double>();
 
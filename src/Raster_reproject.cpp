@@ -9,6 +9,7 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <mutex>
 
 #include "H5Cpp.h"
 
@@ -17,6 +18,8 @@
 #include "Slice.hpp"
 #include "WarpParameters.hpp"
 #include "TileIO.hpp"
+#include "File.hpp"
+#include "CoordinateTransformCache.hpp"
 #include "Exceptions.hpp"
 #include "attributes.hpp"
 
@@ -26,39 +29,18 @@ namespace GeoStar {
 
     
     Point Raster::geographicCoordinateTransform( std::string &srcWKT, std::string &targetWKT, Point pt) {
-        GDALAllRegister();  // NEED HERE ??????~!!!!!!!
-        OGRSpatialReference oSourceSRS, oTargetSRS;
-        OGRCoordinateTransformation *poCT;
-        
-        // This method will wipe the existing SRS definition, and reassign it based on the contents of the passed WKT
-        // string. Only as much of the input string as needed to construct this SRS is consumed from the input string,
-        // and the input string pointer is then updated to point to the remaining (unused) input.
-        //
-        // the calling param to importFromWkt MUST be a char**
-        //
-        
-        char* srcWktChars = new char[srcWKT.length()+1];
-        char* targetWktChars = new char[targetWKT.length()+1];
-        strcpy(srcWktChars, srcWKT.c_str());
-        strcpy(targetWktChars, targetWKT.c_str());
-        
-        oSourceSRS.importFromWkt(&srcWktChars);
-        oTargetSRS.importFromWkt(&targetWktChars);
-        poCT = OGRCreateCoordinateTransformation( &oSourceSRS,
-                                                &oTargetSRS );
+        // the transformation is made (and the WKT parsed) once per file, not once per point:
+        CoordinateTransformCache &cache = image->getFile()->getTransformCache();
         double x, y;
         x = pt.getX();
         y = pt.getY();
         
         Point transformedPt;
         
-        if( poCT == NULL || !poCT->Transform( 1, &x, &y ) ) {
-            throw_CoordinateTransformError("point: "+std::to_string(x)+","+std::to_string(y)+"\nsource WKT: " + srcWKT +
-                                           "\ndestination WKT: " + targetWKT);
+        if (cache.transform(srcWKT, targetWKT, 1, &x, &y) > 0) {
+            throw_CoordinateTransformError("point: "+std::to_string(pt.getX())+","+std::to_string(pt.getY())+
+                                           "\nsource WKT: " + srcWKT + "\ndestination WKT: " + targetWKT);
         } else {
-            //printf( "(%f,%f) -> (%f,%f)\n",
-            //       pt.getX(), pt.getY(),
-            //       x, y );
             transformedPt.setX(x);
             transformedPt.setY(y);
         }
@@ -101,12 +83,16 @@ namespace GeoStar {
         
         Point transformedPt;
         
-        if( poCT == NULL || !poCT->Transform( 1, &x, &y ) ) {
+        if (poCT == NULL) throw_CoordinateTransformError("point: "+std::to_string(x)+","+std::to_string(y)+
+                                                         "\nno transformation");
+        if( !poCT->Transform( 1, &x, &y ) ) {
             char* srcWktChars;
             char* targetWktChars;
             poCT->GetSourceCS()->exportToPrettyWkt(&srcWktChars);
             poCT->GetTargetCS()->exportToPrettyWkt(&targetWktChars);
             std::string srcWkt(srcWktChars), targetWkt(targetWktChars);
+            CPLFree(srcWktChars);
+            CPLFree(targetWktChars);
             throw_CoordinateTransformError("point: "+std::to_string(x)+","+std::to_string(y)+"\nsource WKT: " + srcWkt +
                                            "\ndestination WKT: " + targetWkt);
         } else {
@@ -121,7 +107,8 @@ namespace GeoStar {
 
     
     
-    Raster* Raster::transform(std::string &newWKT, std::string &newRasterName, double newDeltaX, double newDeltaY) {
+    Raster* Raster::transform(std::string &newWKT, std::string &newRasterName, double newDeltaX, double newDeltaY, const int threads,
+                              const double maxError) {
         // Create the new Raster, to hold the transformed raster, using the same type as this raster:
         RasterType type = raster_datatype;
         GeoStar::Raster *rasNew;
@@ -130,11 +117,12 @@ namespace GeoStar {
         } catch (RasterExistsException e) {
             rasNew = image->open_raster(newRasterName);
         }
-        return transform(newWKT, newDeltaX, newDeltaY, rasNew);
+        return transform(newWKT, newDeltaX, newDeltaY, rasNew, threads, maxError);
     }
     
     
-    Raster* Raster::transform(std::string &newWKT, double newDeltaX, double newDeltaY, Raster *rasNew) {
+    Raster* Raster::transform(std::string &newWKT, double newDeltaX, double newDeltaY, Raster *rasNew, const int threads,
+                              const double maxError) {
         // Find the current (0,0) geographic point in the current raster, and the
         //  current deltaX and deltaY for this raster (WKT coords/per raster pixel),
         //  which is the "location" attribute:
@@ -158,30 +146,23 @@ namespace GeoStar {
         lr.y = ll.y;
         
         
-        GDALAllRegister();  // NEED HERE ??????~!!!!!!!
-        OGRSpatialReference oSourceSRS, oTargetSRS;
-        OGRCoordinateTransformation *poCT;
-
         // try {
         std::string wkt = getWKT();
         // } catch (NoWKTdefinedError e) {
         // }
 
-        char* srcWktChars = new char[wkt.length()+1];
-        char* targetWktChars = new char[newWKT.length()+1];
-        strcpy(srcWktChars, wkt.c_str());
-        strcpy(targetWktChars, newWKT.c_str());
-        
-        oSourceSRS.importFromWkt(&srcWktChars);
-        oTargetSRS.importFromWkt(&targetWktChars);
-        poCT = OGRCreateCoordinateTransformation( &oSourceSRS,
-                                                 &oTargetSRS );
-        
-        // get the coordinates of the new raster, using the new WKT, and the current 4 corners:
-        Point newUL = geographicCoordinateTransform(poCT, ul);
-        Point newUR = geographicCoordinateTransform(poCT, ur);
-        Point newLL = geographicCoordinateTransform(poCT, ll);
-        Point newLR = geographicCoordinateTransform(poCT, lr);
+        // get the coordinates of the new raster, using the new WKT, and the current 4 corners (the
+        //  transformations, both ways, are made once per file and WKT pair; see CoordinateTransformCache):
+        CoordinateTransformCache &cache = image->getFile()->getTransformCache();
+        double cornerX[4] = {ul.x, ur.x, ll.x, lr.x};
+        double cornerY[4] = {ul.y, ur.y, ll.y, lr.y};
+        if (cache.transform(wkt, newWKT, 4, cornerX, cornerY) > 0)
+            throw_CoordinateTransformError("raster corners: "+fullRastername+"\nsource WKT: " + wkt +
+                                           "\ndestination WKT: " + newWKT);
+        Point newUL(cornerX[0], cornerY[0]);
+        Point newUR(cornerX[1], cornerY[1]);
+        Point newLL(cornerX[2], cornerY[2]);
+        Point newLR(cornerX[3], cornerY[3]);
 
         // For now, we're passing in newDeltaX and newDeltaY ... but later we can calculate based on doing
         // a geographicCoordinateTransform() for a pixel in the center of this raster, and for the pixel one
@@ -224,42 +205,14 @@ namespace GeoStar {
         rasNew->setWKT(newWKT);
         rasNew->setLocationAttributes(newUL.x, newUL.y, newDeltaX, newDeltaY);
         
-        //  NOW, reset the coordinateTransformation object to switch it's order, from src->target, to
-        //   target->src.  This is decide for each pixel of the target raster, which of these (src) pixels it
-        //   should be mapped from.
-        poCT = OGRCreateCoordinateTransformation(&oTargetSRS,
-                                                 &oSourceSRS );
+        //  NOW, the coordinateTransformation goes the other way, from target->src.  This is to decide for
+        //   each pixel of the target raster, which of these (src) pixels it should be mapped from.
 
         // Now, call the templated tranformType<>() method, based on the new raster type:
-        switch(raster_datatype) {
-            case INT8U:
-                return transformType<uint8_t>(rasNew, poCT, ul, newUL, newDeltaX, newDeltaY);
-                /*
-                 case INT8S:
-                 return transformType<int8_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 case INT16U:
-                 return transformType<uint16_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 case INT16S:
-                 return transformType<int16_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 case INT32U:
-                 return transformType<uint32_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 case INT32S:
-                 return transformType<int32_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 case INT64U:
-                 return transformType<uint64_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 case INT64S:
-                 return transformType<int64_t>(rasNew, poCT, newUL, newDeltaX, newDeltaY);
-                 */
-            case REAL32:
-                return transformType<float>(rasNew, poCT, ul, newUL, newDeltaX, newDeltaY);
-                
-            case REAL64:
-                return transformType<double>(rasNew, poCT, ul, newUL, newDeltaX, newDeltaY);
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        return visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return transformType<T>(rasNew, newWKT, wkt, ul, newUL, newDeltaX, newDeltaY, threads, maxError);
+        }, fullRastername);
         return NULL;
     }
     
@@ -274,46 +227,15 @@ namespace GeoStar {
     // deltaX and deltaY are the changes in wkt-coordinates for each pixel, in the x- and y- directions, respectively.
     // newDeltaX and newDeltaY similarly, are for the new raster being transformed from this raster.
     template <typename T>
-    Raster* Raster::transformType(Raster *outRaster, OGRCoordinateTransformation *poCT, const Point ul,
-                                  const Point newUL, const double newDeltaX, const double newDeltaY) {
+    Raster* Raster::transformType(Raster *outRaster, const std::string &outWKT, const std::string &inWKT, const Point ul,
+                                  const Point newUL, const double newDeltaX, const double newDeltaY,
+                                  const int threads, const double maxError) {
         
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        GeoStar::Slice tileDescriptor(0,0,8,8);
-        int maxNumberSlicesInRam = 70;
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
-        
-        GeoStar::Slice scalingSlice(0,0,2,2,4);
-        
-        GeoStar::Raster *rasNew = outRaster;
-        long int nx = get_nx();
-        long int ny = get_ny();
-        long int xIn0 = 0;   //in.getX0();   ... for Slice in;
-        long int yIn0 = 0;   //in.getY0();
-        long int xInMax = nx - 1;       //xIn0 + in.getDeltaX();
-        long int yInMax = ny - 1;       //yIn0 + in.getDeltaY();
-        
-        long int newNy = outRaster->get_ny();      //sliceOut.getDeltaY();
-        long int newNx = outRaster->get_nx();      //sliceOut.getDeltaX();
-        long int xOut0 = 0;                  //sliceOut.getX0();
-        long int yOut0 = 0;                  //sliceOut.getY0();
-        long int xOutMax = newNx - 1;        //xOut0 + newDeltaX;
-        long int yOutMax = newNy - 1;        //yOut0 + newDeltaY;
-        
-        // TileIO will now handle reading input data.
-        std::vector<T> newData(newNx);    // this will hold ONE ROW of the new image - output slice
-        double xScaled, yScaled;
-        long int oldY, oldX;
-        double xDiff, yDiff;
-        T pixelVal;
         
-        GeoStar::Point pt;    // pt.x and pt.y are double
-        double yVal, xVal;
-        
-        // MAY want to pass in sliceInput/sliceOut LATER ... and use as in above comments.
-        Slice sliceInput(0,0,nx,ny);
-        Slice sliceOut(0,0,newNx,newNy);
-        //sliceInput.setDeltaY(3);
-        sliceOut.setDeltaY(1);
+        // MAY want to pass in sliceInput/sliceOut LATER ...
+        Slice sliceInput(0,0,get_nx(),get_ny());
+        Slice sliceOut(0,0,outRaster->get_nx(),outRaster->get_ny());
         
         // NOTE: deltaX and deltaY are the wkt-coordinate differences for each pixel in this raster, for the
         //       x- and y- directions.  And, newDeltaX and newDeltaY are the wkt-coordinate differences for this
@@ -326,82 +248,69 @@ namespace GeoStar {
         double halfDeltaX = deltaX * 0.5;
         double halfDeltaY = deltaY * 0.5;
         
-        double xcoord, ycoord;  // the (new)wkt coordinates of the current pixel being written to the new raster
-        
-        for (long int i = yOut0; i < yOutMax; i++) {
-            yVal = static_cast<double>(i);
-            // convert this pixel coordinate to the wkt coordinates
-            ycoord = newUL.y + (halfNewDeltaY) + (newDeltaY*i);
-            for (long int j = xOut0; j < xOutMax; j++) {
-                xVal = static_cast<double>(j);
-                // convert this pixel coordinate to the wkt coordinates
-                xcoord = newUL.x + (halfNewDeltaX) + (newDeltaX*j);
-
-                pt = geographicCoordinateTransform(poCT, xcoord, ycoord);
-                
-                // Now that we have the cooresponding wkt-coordinates for this raster, we need to convert them to
-                //  this raster's pixel coordinates:
-                xScaled = ((pt.x - ul.x) - halfDeltaX) * oneOverDeltaX;
-                
-                oldX = static_cast<long> (xScaled);
-                
-                // IMPORTANT ... getNearest() can sometimes add 1 to the pixel coordinate (oldX/oldY) ...
-                //  so if it does that, and it is one pixel beyond the current raster coordinates, then need to do
-                //  the OUT-OF-BOUNDS test AFTER calling getNearest():
-                xDiff = xScaled - static_cast<long>(oldX);
-                getNearest(oldX, xDiff);
+        // an OGRCoordinateTransformation is not safe to use from two threads at once: run alone, this
+        //  uses the file's cached transformation; on a pool, each call borrows one of its own from
+        //  the cache (see CoordinateTransformCache::transformPooled)
+        CoordinateTransformCache &cache = image->getFile()->getTransformCache();
+        bool alone = (threads == 1);
 
-                // Test for pixel coordinate OUT-OF-BOUNDS:
-                if (oldX < xIn0) {
-                    newData[j] = 0;
-                    continue;
-                } else if (oldX >= xInMax) {
-                    newData[j] = 0;
-                    continue;
-                }
-                
-                yScaled = ((pt.y - ul.y) - halfDeltaY) * oneOverDeltaY;
-                
-                oldY = static_cast<long> (yScaled);
-                
-                // IMPORTANT ... getNearest() can sometimes add 1 to the pixel coordinate (oldX/oldY) ...
-                //  so if it does that, and it is one pixel beyond the current raster coordinates, then need to do
-                //  the OUT-OF-BOUNDS test AFTER calling getNearest():
-                yDiff = yScaled - static_cast<long>(oldY);
-                getNearest(oldY, yDiff);
+        // the exact mapping, from output pixels to input pixels:
+        ApproxTransformer::RowFunction exactRow = [&](const long int &i, const long int &j0, const long int &n,
+                                                      double *xs, double *ys) {
+            // convert these pixel coordinates to the wkt coordinates
+            double ycoord = newUL.y + (halfNewDeltaY) + (newDeltaY*i);
+            for (long int k = 0; k < n; k++) {
+                xs[k] = newUL.x + (halfNewDeltaX) + (newDeltaX*(j0 + k));
+                ys[k] = ycoord;
+            }
+            // ... transform them all in one call (points that do not transform come back as NaN, and
+            //  are left 0 in the output) ...
+            if (alone) cache.transform(outWKT, inWKT, n, xs, ys);
+            else cache.transformPooled(outWKT, inWKT, n, xs, ys);
+            // ... and convert the cooresponding wkt-coordinates for this raster to this raster's
+            //  pixel coordinates:
+            for (long int k = 0; k < n; k++) {
+                xs[k] = ((xs[k] - ul.x) - halfDeltaX) * oneOverDeltaX;
+                ys[k] = ((ys[k] - ul.y) - halfDeltaY) * oneOverDeltaY;
+            }
+        };
+        // ... called only at a few points of each row, interpolating in between (to within maxError):
+        ApproxTransformer approx(exactRow, maxError);
 
-                if (oldY < yIn0) {
-                    newData[j] = 0;
-                    continue;
-                } else if (oldY >= yInMax) {
-                    newData[j] = 0;
-                    continue;
-                }
-                
-                pixelVal = getScaledPixelFromTile<T>(oldY, oldX, xDiff, yDiff, sliceInput, scalingSlice, reader);
-                
-                newData[j] = pixelVal;
-           }
-            sliceOut.setY0(i);
-            //std::cerr << " * " << i << std::endl;
-            rasNew->write(sliceOut,newData);
-            //std::cerr << " here " << std::endl;
-
-        }
+        // a block (chunk) of the output at a time, from one read of the input window it maps to
+        //  (see resampleEngine):
+        resampleEngine<T>(sliceInput, sliceOut, outRaster, [&](const long int &i, const long int &j0, const long int &n,
+                                                               double *xs, double *ys) {
+            approx.transformRow(i, j0, n, xs, ys);
+        }, threads);
         
         std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
         std::cout << "transform execution duration: " << duration << std::endl;
         
-        return rasNew;
+        return outRaster;
     }
 
     
-    template Raster* Raster::transformType<uint8_t>(Raster*, OGRCoordinateTransformation*, const Point,
-                                                    const Point, const double, const double);
-    template Raster* Raster::transformType<float>(Raster*, OGRCoordinateTransformation*, const Point,
-                                                  const Point, const double, const double);
-    template Raster* Raster::transformType<double>(Raster*, OGRCoordinateTransformation*, const Point,
-                                                   const Point, const double, const double);
+    template Raster* Raster::transformType<uint8_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                    const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<int8_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                   const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<uint16_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                     const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<int16_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                    const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<uint32_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                     const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<int32_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                    const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<uint64_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                     const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<int64_t>(Raster*, const std::string&, const std::string&, const Point,
+                                                    const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<float>(Raster*, const std::string&, const std::string&, const Point,
+                                                  const Point, const double, const double, const int, const double);
+    template Raster* Raster::transformType<double>(Raster*, const std::string&, const std::string&, const Point,
+                                                   const Point, const double, const double, const int, const double);
 
 }// end namespace GeoStar
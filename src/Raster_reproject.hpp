@@ -52,8 +52,9 @@ The constructors should only be called by the Image class: Image::createRaster.
   private:
 
       template <typename T>
-      Raster* transformType(Raster *outRaster, OGRCoordinateTransformation *poCT, const Point ul, const Point newUL,
-                            const double newDeltaX, const double newDeltaY);
+      Raster* transformType(Raster *outRaster, const std::string &outWKT, const std::string &inWKT, const Point ul, const Point newUL,
+                            const double newDeltaX, const double newDeltaY, const int threads = 1,
+                            const double maxError = ApproxTransformer::DEFAULT_MAX_ERROR);
       
 
   public:
@@ -62,8 +63,13 @@ The constructors should only be called by the Image class: Image::createRaster.
       Point geographicCoordinateTransform( OGRCoordinateTransformation *poCT, Point pt);
       Point geographicCoordinateTransform( OGRCoordinateTransformation *poCT, const double xval, const double yval);
       // return a new raster, which is tranformed from this raster, using a new WKT and given raster name:
-      Raster* transform(std::string &newWKT, std::string &newRasterName, double newDeltaX, double newDeltaY);
-      // return the new raster, which is tranformed from this raster, using a new WKT and given newly created raster object:
-      Raster* transform(std::string &newWKT, double newDeltaX, double newDeltaY, Raster *outRaster);
+      Raster* transform(std::string &newWKT, std::string &newRasterName, double newDeltaX, double newDeltaY, const int threads = 1,
+                        const double maxError = ApproxTransformer::DEFAULT_MAX_ERROR);
+      // return the new raster, which is tranformed from this raster, using a new WKT and given newly created raster object.
+      //  threads: the number of threads computing output blocks (0: one per core)
+      //  maxError: the largest error, in input pixels, allowed in the coordinates interpolated between
+      //   exactly transformed points (see ApproxTransformer); 0 transforms every pixel exactly
+      Raster* transform(std::string &newWKT, double newDeltaX, double newDeltaY, Raster *outRaster, const int threads = 1,
+                        const double maxError = ApproxTransformer::DEFAULT_MAX_ERROR);
       // return a new raster, which has been flipped from this raster, either horizontally, vertically, or both:
 
@@ -0,0 +1,177 @@
+// Raster_resample.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <cmath>
+
+#include "H5Cpp.h"
+
+#include "Image.hpp"
+#include "Raster.hpp"
+#include "Slice.hpp"
+#include "TileIO.hpp"
+#include "Exceptions.hpp"
+#include "attributes.hpp"
+
+namespace GeoStar {
+
+    const long int Raster::RESAMPLE_WINDOW_BUDGET;
+
+
+
+    template <typename T>
+    bool Raster::resampleBlock(const Slice &in, const Slice &block, const RowMapping &mapRow,
+                               T *out, const long int &outStride, std::mutex &io) const {
+        long int bx0 = block.getX0(), by0 = block.getY0();
+        long int bw = block.getDeltaX(), bh = block.getDeltaY();
+        long int inX0 = in.getX0(), inY0 = in.getY0();
+        long int inX1 = inX0 + in.getDeltaX(), inY1 = inY0 + in.getDeltaY();
+
+        // where every pixel of the block comes from:
+        std::vector<double> xs(bw*bh), ys(bw*bh);
+        for (long int r = 0; r < bh; r++) mapRow(by0 + r, bx0, bw, &xs[r*bw], &ys[r*bw]);
+
+        double minX = std::numeric_limits<double>::max(), maxX = -minX;
+        double minY = minX, maxY = -minX;
+        bool allFinite = true;
+        for (long int k = 0; k < bw*bh; k++) {
+            if (!std::isfinite(xs[k]) || !std::isfinite(ys[k])) {
+                allFinite = false;
+                continue;
+            }
+            minX = std::min(minX, xs[k]);
+            maxX = std::max(maxX, xs[k]);
+            minY = std::min(minY, ys[k]);
+            maxY = std::max(maxY, ys[k]);
+        }// endfor: k
+
+        // the input window: the pixels below and right of every coordinate, inside 'in':
+        long int wx0 = inX0, wx1 = inX0, wy0 = inY0, wy1 = inY0;
+        if (minX <= maxX) {
+            // (clamped as doubles first: a wild coordinate would overflow a long int)
+            wx0 = (long int)std::max((double)inX0, std::floor(minX));
+            wx1 = (long int)std::min((double)inX1, std::floor(maxX) + 2);
+            wy0 = (long int)std::max((double)inY0, std::floor(minY));
+            wy1 = (long int)std::min((double)inY1, std::floor(maxY) + 2);
+        }
+        if (wx0 >= wx1 || wy0 >= wy1) {
+            for (long int r = 0; r < bh; r++) std::fill(out + r*outStride, out + r*outStride + bw, (T)0);
+            return false;
+        }
+
+        // a window too big to hold (a strong reduction, or a long diagonal band): halve the block
+        long int ww = wx1 - wx0, wh = wy1 - wy0;
+        if (ww * wh > RESAMPLE_WINDOW_BUDGET && bw * bh > 1) {
+            Slice first = block, second = block;
+            if (bw >= bh) {
+                first.setDeltaX(bw/2);
+                second.setX0(bx0 + bw/2);
+                second.setDeltaX(bw - bw/2);
+            } else {
+                first.setDeltaY(bh/2);
+                second.setY0(by0 + bh/2);
+                second.setDeltaY(bh - bh/2);
+            }
+            long int offset = (second.getY0() - by0) * outStride + (second.getX0() - bx0);
+            bool a = resampleBlock(in, first, mapRow, out, outStride, io);
+            bool b = resampleBlock(in, second, mapRow, out + offset, outStride, io);
+            return a || b;
+        }
+
+        // (through the shared tile cache: the tiles of the window are read once for all blocks,
+        //  threads and operations that need them)
+        std::vector<T> win(ww * wh);
+        TileIO<T>::readWindow(this, Slice(wx0, wy0, ww, wh), &win[0], io);
+
+        // interpolate in double: negating a wide unsigned pixel would wrap around
+        if (allFinite && std::floor(minX) >= inX0 && std::floor(maxX) + 1 < inX1
+                      && std::floor(minY) >= inY0 && std::floor(maxY) + 1 < inY1) {
+            // the interior: every 2x2 neighbourhood is in the window, no checks
+            for (long int r = 0; r < bh; r++) {
+                const double *xr = &xs[r*bw];
+                const double *yr = &ys[r*bw];
+                T *o = out + r*outStride;
+                for (long int c = 0; c < bw; c++) {
+                    double fx0 = std::floor(xr[c]), fy0 = std::floor(yr[c]);
+                    double fx = xr[c] - fx0, fy = yr[c] - fy0;
+                    const T *p = &win[((long int)fy0 - wy0) * ww + ((long int)fx0 - wx0)];
+                    double top = (double)p[0] + ((double)p[1] - (double)p[0]) * fx;
+                    double bottom = (double)p[ww] + ((double)p[ww+1] - (double)p[ww]) * fx;
+                    o[c] = (T)(top + (bottom - top) * fy);
+                }// endfor: c
+            }// endfor: r
+        } else {
+            // the border: pixels whose nearest input pixel is outside are 0, and the neighbours
+            //  past the edge of the input repeat the edge
+            for (long int r = 0; r < bh; r++) {
+                const double *xr = &xs[r*bw];
+                const double *yr = &ys[r*bw];
+                T *o = out + r*outStride;
+                for (long int c = 0; c < bw; c++) {
+                    double x = xr[c], y = yr[c];
+                    if (!std::isfinite(x) || !std::isfinite(y)) {
+                        o[c] = 0;
+                        continue;
+                    }
+                    double nearX = std::floor(x + 0.5), nearY = std::floor(y + 0.5);
+                    if (nearX < inX0 || nearX >= inX1 || nearY < inY0 || nearY >= inY1) {
+                        o[c] = 0;
+                        continue;
+                    }
+                    double fx0 = std::floor(x), fy0 = std::floor(y);
+                    double fx = x - fx0, fy = y - fy0;
+                    long int c0 = std::min(wx1 - 1, std::max(wx0, (long int)fx0)) - wx0;
+                    long int c1 = std::min(wx1 - 1, std::max(wx0, (long int)fx0 + 1)) - wx0;
+                    long int r0 = std::min(wy1 - 1, std::max(wy0, (long int)fy0)) - wy0;
+                    long int r1 = std::min(wy1 - 1, std::max(wy0, (long int)fy0 + 1)) - wy0;
+                    double top = (double)win[r0*ww + c0] + ((double)win[r0*ww + c1] - (double)win[r0*ww + c0]) * fx;
+                    double bottom = (double)win[r1*ww + c0] + ((double)win[r1*ww + c1] - (double)win[r1*ww + c0]) * fx;
+                    o[c] = (T)(top + (bottom - top) * fy);
+                }// endfor: c
+            }// endfor: r
+        }
+        return true;
+    }// end: resampleBlock
+
+
+
+    template <typename T>
+    void Raster::resampleEngine(const Slice &in, const Slice &out, Raster *outRaster, const RowMapping &mapRow,
+                                const int &threads) const {
+        // chunk cache for this access pattern (restored at the end): each block reads a window
+        ChunkCacheGuard inCache(this, windowCache());
+
+        // a new output already reads as 0 everywhere: blocks that map entirely outside the input
+        //  are not written, so their chunks are never allocated.
+        bool blankOut = outRaster->isBlankFill(0.0);
+
+        std::vector<Slice> blocks = outRaster->blockSlices(out);
+        parallelBlocks<T>(blocks, outRaster, threads, [&](const Slice &block, std::vector<T> &data, std::mutex &io) {
+            data.resize(block.getDeltaX() * block.getDeltaY());
+            bool covered = resampleBlock<T>(in, block, mapRow, &data[0], block.getDeltaX(), io);
+            return covered || !blankOut;
+        });
+    }// end: resampleEngine
+
+
+
+    template void Raster::resampleEngine<uint8_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<int8_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<uint16_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<int16_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<uint32_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<int32_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<uint64_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<int64_t>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<float>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+    template void Raster::resampleEngine<double>(const Slice&, const Slice&, Raster*, const RowMapping&, const int&) const;
+
+}// end namespace GeoStar
@@ -0,0 +1,73 @@
+// Raster_resample.hpp
+//
+//----------------------------------------
+
+/** \brief Raster -- Implementation of raster operations for HDF5-based GeoStar files.
+
+
+This class is used as the standard interface for raster operations
+ that are used for storing and processing of data in GeoStar using the HDF5 implementation.
+In particular, first, data is imported into GeoStar from data provided by a remote sensing data
+processing facility, or the output from another data processing system.
+This data is stored in the GeoStar file format.
+
+\see File, Image, Raster, RasterType, Slice, WarpParameters, TileIO
+
+\par Usage Overview
+The Raster class is meant to be used when dealing with GeoStar files.
+Other classes are used to deal with external files in other formats.
+This class provides methods for reading and writing rasters, as well as scaling and warping them.
+
+Reading a raster requires a slice object, which describes the rectangular portion of the raster to read,
+along with a templated vector buffer, to write the data into.
+
+Writing a raster requires a slice object, which describes the rectangular portion of the raster to write
+into, along with a templated vector buffer from which to write the data.
+
+Scaling a raster is possible using several different approaches.  The scale functions return a new Raster
+object, which contains the scaled data from the calling Raster.  See scale function documentation for
+more details.
+
+Warping a raster is possible using several different approaches.  The warp functions return a new Raster
+object, which contains the warped data from the calling Raster.  See warp function documentation for
+more details.
+ 
+Rotating a raster is possible using two different methods, "rotate" and "rotateWithWarp".  Currently "rotate" is
+preferred, as it is faster; "rotateWithWarp" is left in as a legacy function, for possible future testing.  For the
+simple "rotate" function, there are two approaches.  See rotate function documentation for more details.
+
+\par Details
+This class also has functions to display the raster width and height, and get and set functions for the
+raster type.
+
+The class keeps track of the rastername, in case that is needed.
+
+The constructors should only be called by the Image class: Image::createRaster.
+
+*/
+
+
+  private:
+      // largest input window read for one output block (in pixels); bigger ones split the block
+      static const long int RESAMPLE_WINDOW_BUDGET = 4194304;
+
+      // maps the output pixels (x0 .. x0+n-1, y) to input pixel coordinates (xs[k], ys[k]); pixel
+      //  centres are at whole numbers.  Coordinates that are not finite map outside the input.
+      typedef std::function<void(const long int &y, const long int &x0, const long int &n,
+                                 double *xs, double *ys)> RowMapping;
+
+      // the resampling engine behind warp, rotate and reproject: fills the 'out' window of
+      //  outRaster, block by block (outRaster's chunks), from the 'in' window of this raster,
+      //  bilinearly interpolated at the coordinates given by mapRow.  Output pixels whose nearest
+      //  input pixel is outside 'in' are 0.  The blocks are computed on 'threads' threads (see
+      //  parallelBlocks), so mapRow must be safe to call from several threads at once.
+      template <typename T>
+      void resampleEngine(const Slice &in, const Slice &out, Raster *outRaster, const RowMapping &mapRow,
+                          const int &threads = 1) const;
+
+      // resamples one output block into out (rows outStride apart): maps all its pixels, reads the
+      //  input window they cover (plus the interpolation neighbour) through the shared tile cache
+      //  (TileIO::readWindow, holding 'io' for each HDF5 read), and interpolates from that buffer.  Returns false if no pixel of the block falls in the input.
+      template <typename T>
+      bool resampleBlock(const Slice &in, const Slice &block, const RowMapping &mapRow,
+                         T *out, const long int &outStride, std::mutex &io) const;
@@ -52,7 +52,7 @@ The constructors should only be called by the Image class: Image::createRaster.
   private:
 
       template <typename T>
-      Raster* rotateType(const float angle, const Slice &in, const Slice &out, Raster *outRaster);
+      Raster* rotateType(const float angle, const Slice &in, const Slice &out, Raster *outRaster, const int threads = 1);
       
 
   public:
@@ -118,7 +118,7 @@ The constructors should only be called by the Image class: Image::createRaster.
        \endcode
        
        */
-      Raster* rotate(const float angle);
+      Raster* rotate(const float angle, const int threads = 1);
       
       /** \brief Raster:rotate create a new raster, that is a rotated version of this raster.
        
@@ -132,6 +132,8 @@ The constructors should only be called by the Image class: Image::createRaster.
        The angle to rotate the (entire) input raster, in radians.
        \param[in] inSlice
        The input slice information - class type Slice.
+       \param[in] threads
+       The number of threads computing output blocks (0: one per core; default 1).
 
        \returns
        new rotated Raster.
@@ -182,9 +184,9 @@ The constructors should only be called by the Image class: Image::createRaster.
        \endcode
        
        */
-      Raster* rotate(const float angle, const Slice &in);
-      Raster* rotate(const float angle, Raster *outRaster);
-      Raster* rotate(const float angle, const Slice &in, Raster *outRaster);
+      Raster* rotate(const float angle, const Slice &in, const int threads = 1);
+      Raster* rotate(const float angle, Raster *outRaster, const int threads = 1);
+      Raster* rotate(const float angle, const Slice &in, Raster *outRaster, const int threads = 1);
       Raster* rotate(const float angle, const Slice &in, const Slice &out, Raster *outRaster);
       //Raster* rotateType(const float angle, const Slice &in, const Slice &out, Raster *outRaster);
 
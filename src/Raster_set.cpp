@@ -17,12 +17,121 @@
 #include "Slice.hpp"
 #include "WarpParameters.hpp"
 #include "TileIO.hpp"
+#include "SharedTileCache.hpp"
 #include "Exceptions.hpp"
 #include "attributes.hpp"
 #include "RasterFunction.hpp"
 
 namespace GeoStar {
 
+    template <typename T>
+    void Raster::checkPixelType(const T &pixelVal) const {
+        std::string givenType = typeid(pixelVal).name();
+        std::string correctType;
+        correctType = visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type RasT;
+            return std::string(typeid(RasT).name());
+        }, fullRastername);
+        if (givenType.compare(correctType) != 0)
+            throw_InvalidPixelValueType(fullRastername+"type given: "+givenType+
+                                        "required type: "+correctType);
+    }
+
+
+
+    double Raster::getFillValue() const {
+        double value = 0.0;
+        rasterobj->getCreatePlist().getFillValue(H5::PredType::NATIVE_DOUBLE, &value);
+        return value;
+    }
+
+
+
+    bool Raster::soleOpenHandle() const {
+        hid_t id = rasterobj->getId();
+        H5O_info_t mine;
+        if (H5Oget_info(id, &mine) < 0) return false;
+        if (mine.rc != 1) return false;      // another link to the same dataset
+
+        // the datasets open in the file (through any H5File of it), and which of them are this one:
+        hid_t fileId = H5Iget_file_id(id);
+        if (fileId < 0) return false;
+        ssize_t nopen = H5Fget_obj_count(fileId, H5F_OBJ_DATASET);
+        std::vector<hid_t> ids((nopen > 0) ? nopen : 0);
+        if (nopen > 0) nopen = H5Fget_obj_ids(fileId, H5F_OBJ_DATASET, ids.size(), &ids[0]);
+        H5Fclose(fileId);
+        if (nopen < 0) return false;
+
+        int handles = 0;
+        for (ssize_t k = 0; k < nopen; k++) {
+            H5O_info_t other;
+            if (H5Oget_info(ids[k], &other) < 0) return false;
+            if (other.fileno == mine.fileno && other.addr == mine.addr) handles++;
+        }// endfor: k
+        return handles == 1;
+    }// end: soleOpenHandle
+
+
+
+    template <typename T>
+    void Raster::refill(const T &pixelVal) {
+        // everything needed to make the dataset again:
+        H5::DataType type = rasterobj->getDataType();     // the storage type, e.g. n-bit
+        H5::DataSpace space = rasterobj->getSpace();
+        H5::DSetCreatPropList cparms = rasterobj->getCreatePlist();
+        cparms.setFillValue(Raster::getHdf5Type<T>(), &pixelVal);
+        cparms.setFillTime(H5D_FILL_TIME_IFSET);
+        cparms.setAllocTime((cparms.getLayout() == H5D_CHUNKED) ? H5D_ALLOC_TIME_INCR : H5D_ALLOC_TIME_LATE);
+        ChunkCache cache = getChunkCache();
+
+        // the attributes (location, wkt, object_type, ...), as raw bytes: GeoStar attributes are
+        //  fixed-length strings and numbers, so no pointers are copied.
+        std::vector<std::string> attrNames;
+        std::vector<H5::DataType> attrTypes;
+        std::vector<H5::DataSpace> attrSpaces;
+        std::vector<std::vector<char> > attrData;
+        int nattrs = rasterobj->getNumAttrs();
+        for (int k = 0; k < nattrs; k++) {
+            H5::Attribute att = rasterobj->openAttribute((unsigned int)k);
+            attrNames.push_back(att.getName());
+            attrTypes.push_back(att.getDataType());
+            attrSpaces.push_back(att.getSpace());
+            attrData.push_back(std::vector<char>(attrTypes[k].getSize() * attrSpaces[k].getSimpleExtentNpoints()));
+            att.read(attrTypes[k], &attrData[k][0]);
+        }// endfor: k
+
+        SharedTileCache::instance().invalidate(fullRastername);
+        delete rasterobj;
+        rasterobj = NULL;
+        image->delete_raster(rastername);
+        try {
+            rasterobj = new H5::DataSet(image->createDataset(rastername, type, space, cparms));
+            for (int k = 0; k < nattrs; k++) {
+                H5::Attribute att = rasterobj->createAttribute(attrNames[k], attrTypes[k], attrSpaces[k]);
+                att.write(attrTypes[k], &attrData[k][0]);
+            }// endfor: k
+        } catch (const H5::Exception &e) {
+            throw_RasterWriteError(fullRastername + "  " + e.getDetailMsg());
+        }
+        setChunkCache(cache);
+    }// end: refill
+
+
+
+    bool Raster::refillable(const Slice &in) const {
+        // a band shares its dataset with the other bands, and appendRows holds rows in memory:
+        if (band >= 0 || appendRow >= 0) return false;
+        if (in.getX0() != 0 || in.getY0() != 0 || in.getDeltaX() != get_nx() || in.getDeltaY() != get_ny())
+            return false;
+        // HDF5 does not give back the space of a deleted dataset, so one with stored pixels is
+        //  written over instead (making it again would grow the file by the raster's size):
+        if (rasterobj->getStorageSize() != 0) return false;
+        // making the dataset again would leave other handles on it pointing at the old one:
+        return soleOpenHandle();
+    }// end: refillable
+
+
+
     template <typename T>
     void Raster::setPixels(T pixelVal) {
         Slice in(0,0,get_nx(),get_ny());
@@ -34,72 +143,55 @@ namespace GeoStar {
     void Raster::setPixels(Slice in, T pixelVal) {
         
         // First verify that 'pixelVal' is the correct type for this raster:
-        std::string givenType = typeid(pixelVal).name();
-        std::string correctType;
-        switch(raster_datatype) {
-            case INT8U:
-                uint8_t uint8_tVar;
-                correctType = typeid(uint8_tVar).name();
-                break;
-                /*
-                 case INT8S:
-                 case INT16U:
-                 case INT16S:
-                 case INT32U:
-                 case INT32S:
-                 case INT64U:
-                 case INT64S:
-                 */
-            case REAL32:
-                float floatVar;
-                correctType = typeid(floatVar).name();
-                break;
-
-            case REAL64:
-                double doubleVar;
-                correctType = typeid(doubleVar).name();
-                break;
-
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
-        if (givenType.compare(correctType) != 0)
-            throw_InvalidPixelValueType(fullRastername+"type given: "+givenType+
-                                        "required type: "+correctType);
+        checkPixelType(pixelVal);
 
-        
-        long int nx = in.getDeltaX();
-        long int ny = in.getDeltaY();
-        long int xIn0 = in.getX0();
-        long int yIn0 = in.getY0();
-        long int xInMax = xIn0 + nx;
-        long int yInMax = yIn0 + ny;
-        
-        std::vector<T> data(nx);             // new data;  this will hold the output slice
-        in.setDeltaY(1);
-        for (int j = 0; j < nx; j++)
-            data[j] = pixelVal;
-
-        for (int i = yIn0; i < yInMax; i++) {
-            in.setY0(i);
-            try {
-                this->write(in,data);
-            } catch (const H5::DataSetIException& e) {
-                std::cerr << "H5::DataSetIException  for '" << fullRastername << "'  " << e.getCDetailMsg() << std::endl;
-            }
+        if (refillable(in)) {
+            refill(pixelVal);
+            return;
         }
+
+        // otherwise write the pixels, a chunk at a time (write throws RasterWriteError):
+        std::vector<Slice> blocks = blockSlices(in);
+        std::vector<T> data;
+        for (size_t b = 0; b < blocks.size(); b++) {
+            data.assign(blocks[b].getDeltaX() * blocks[b].getDeltaY(), pixelVal);
+            this->write(blocks[b],data);
+        }// endfor: b
         return;
     }
     
     
 
+    template void Raster::refill<uint8_t>(const uint8_t &);
+    template void Raster::refill<int8_t>(const int8_t &);
+    template void Raster::refill<uint16_t>(const uint16_t &);
+    template void Raster::refill<int16_t>(const int16_t &);
+    template void Raster::refill<uint32_t>(const uint32_t &);
+    template void Raster::refill<int32_t>(const int32_t &);
+    template void Raster::refill<uint64_t>(const uint64_t &);
+    template void Raster::refill<int64_t>(const int64_t &);
+    template void Raster::refill<float>(const float &);
+    template void Raster::refill<double>(const double &);
+
     template void Raster::setPixels<uint8_t>(uint8_t);
+    template void Raster::setPixels<int8_t>(int8_t);
+    template void Raster::setPixels<uint16_t>(uint16_t);
+    template void Raster::setPixels<int16_t>(int16_t);
+    template void Raster::setPixels<uint32_t>(uint32_t);
+    template void Raster::setPixels<int32_t>(int32_t);
+    template void Raster::setPixels<uint64_t>(uint64_t);
+    template void Raster::setPixels<int64_t>(int64_t);
     template void Raster::setPixels<float>(float);
     template void Raster::setPixels<double>(double);
 
     template void Raster::setPixels<uint8_t>(Slice, uint8_t);
+    template void Raster::setPixels<int8_t>(Slice, int8_t);
+    template void Raster::setPixels<uint16_t>(Slice, uint16_t);
+    template void Raster::setPixels<int16_t>(Slice, int16_t);
+    template void Raster::setPixels<uint32_t>(Slice, uint32_t);
+    template void Raster::setPixels<int32_t>(Slice, int32_t);
+    template void Raster::setPixels<uint64_t>(Slice, uint64_t);
+    template void Raster::setPixels<int64_t>(Slice, int64_t);
     template void Raster::setPixels<float>(Slice, float);
     template void Raster::setPixels<double>(Slice, double);
 
@@ -51,11 +51,44 @@ The constructors should only be called by the Image class: Image::createRaster.
 
   private:
 
+      // throws InvalidPixelValueType unless T is this raster's pixel type
+      template <typename T>
+      void checkPixelType(const T &pixelVal) const;
+
+      // make the dataset again, empty, with the same type, size, layout and attributes, and the
+      //  given fill value: every pixel then reads as pixelVal, and no chunk is allocated.
+      template <typename T>
+      void refill(const T &pixelVal);
+
+      // true if this Raster is the only open handle (and the only link) to its dataset, so the
+      //  dataset can be made again (refill) without leaving another handle on the old one
+      bool soleOpenHandle() const;
+
+      // true if setting the pixels of slice in to one value can be done by refill: the slice is
+      //  the whole raster, nothing is stored yet (see setPixels), and soleOpenHandle
+      bool refillable(const Slice &in) const;
+
   public:
+      // sets every pixel of this raster to pixelVal.
+      //  T must be the raster's pixel type (InvalidPixelValueType otherwise).
+      //  When no pixels of the raster are stored yet (a new output, say) and this Raster is the
+      //  only open handle on its dataset, no pixels are written: the dataset is made again with
+      //  pixelVal as its fill value (same size, type, layout and attributes), so it takes the same
+      //  (short) time for any raster size.
+      //  Otherwise the pixels are written a chunk at a time, and every handle sees the new values.
+      //  That is the case when another Raster, or any other HDF5 handle, is open on the same
+      //  dataset, for a band of a band stack, for a raster being appended to, and for a raster
+      //  with stored pixels: HDF5 does not give back the file space of a deleted dataset, so
+      //  making it again would grow the file by the raster's size each time.
       template <typename T>
       void setPixels(T pixelVal);
 
+      // sets the pixels of the slice to pixelVal (a whole-raster slice is the same as setPixels(pixelVal))
       template <typename T>
       void setPixels(Slice in, T pixelVal);
 
+      // the value of pixels that were never written (0, unless a fill value was set when the raster
+      //  was created, see RasterLayout::setFillValue, or by setPixels)
+      double getFillValue() const;
+
 
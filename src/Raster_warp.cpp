@@ -9,6 +9,8 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <cmath>
+#include <algorithm>
 
 //#include "H5Cpp.h"
 
@@ -25,7 +27,7 @@ namespace GeoStar {
    
     
     
-    Raster* Raster::rotateWithWarp(const float angle, const Slice &inSlice) {
+    Raster* Raster::rotateWithWarp(const float angle, const Slice &inSlice, const int threads) {
         // if angle in degrees: cos(angle*PI/180) ....
         Slice in = inSlice;
         int inputX0 = in.getX0();
@@ -109,7 +111,7 @@ namespace GeoStar {
         // go backwards, because we will START with the new output coordinates, and map them to the
         //  old input coordinates:
         warpData.GCPRegression2D(rox, roy, rix, riy, &order, &rmsx, &rmsy);
-        return warp(warpData, in, out, rasNew);
+        return warp(warpData, in, out, rasNew, threads);
     }
 
     
@@ -118,7 +120,7 @@ namespace GeoStar {
     
     // warp #1:
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const int threads) {
         // default input slice:
         Slice in(0, 0, get_nx(), get_ny());
         
@@ -132,13 +134,13 @@ namespace GeoStar {
         } catch (RasterExistsException e) {
             rasNew = image->open_raster(name);
         }
-        return warp(inputGCPs, outputGCPs, in, rasNew);   // calls warp #6
+        return warp(inputGCPs, outputGCPs, in, rasNew, threads);   // calls warp #6
     }
     
     
     // warp #2:
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const int threads) {
         std::string name = rastername+"WARP";
         RasterType type = raster_datatype;
         
@@ -149,7 +151,7 @@ namespace GeoStar {
         } catch (RasterExistsException e) {
             rasNew = image->open_raster(name);
         }
-        return warp(inputGCPs, outputGCPs, inSlice, rasNew);   // calls warp #6
+        return warp(inputGCPs, outputGCPs, inSlice, rasNew, threads);   // calls warp #6
     }
 
     
@@ -157,7 +159,7 @@ namespace GeoStar {
     
     // warp #3
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const std::string &name) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const std::string &name, const int threads) {
         // default input slice:
         Slice in(0, 0, get_nx(), get_ny());
         
@@ -170,14 +172,14 @@ namespace GeoStar {
         } catch (RasterExistsException e) {
             rasNew = image->open_raster(name);
         }
-        return warp(inputGCPs, outputGCPs, in, rasNew);   // calls warp #6
+        return warp(inputGCPs, outputGCPs, in, rasNew, threads);   // calls warp #6
     }
     
     
     
     // warp #4
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const std::string &name) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const std::string &name, const int threads) {
         RasterType type = raster_datatype;
         
         GeoStar::Raster *rasNew;
@@ -187,17 +189,17 @@ namespace GeoStar {
         } catch (RasterExistsException e) {
             rasNew = image->open_raster(name);
         }
-        return warp(inputGCPs, outputGCPs, inSlice, rasNew);   // calls warp #6
+        return warp(inputGCPs, outputGCPs, inSlice, rasNew, threads);   // calls warp #6
     }
     
     
     
     // warp #5
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, Raster *rasNew) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, Raster *rasNew, const int threads) {
         // default input slice:
         Slice in(0, 0, get_nx(), get_ny());
-        return warp(inputGCPs, outputGCPs, in, rasNew);  // calls warp #6
+        return warp(inputGCPs, outputGCPs, in, rasNew, threads);  // calls warp #6
     }
 
     
@@ -215,7 +217,7 @@ namespace GeoStar {
     //  as needed:
     //
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice inSlice, Raster *rasNew) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice inSlice, Raster *rasNew, const int threads) {
         // FORCE the number of ground control points to be ODD:
         int ngcp = (inputGCPs.size()/2) * 2;
         if (ngcp == inputGCPs.size()) ngcp--;
@@ -266,7 +268,7 @@ namespace GeoStar {
         //Slice in(getX0(), getY0(), get_nx(), get_ny());
         Slice out(0,0,newNx,newNy);
 
-        return warp(warpData, inSlice, out, rasNew);
+        return warp(warpData, inSlice, out, rasNew, threads);
     }
     
     
@@ -274,7 +276,7 @@ namespace GeoStar {
     // warp #7
     //
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, const std::string &name) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, const std::string &name, const int threads) {
         RasterType type = raster_datatype;
         
         GeoStar::Raster *rasNew;
@@ -285,7 +287,7 @@ namespace GeoStar {
             rasNew = image->open_raster(name);
         }
 
-        return warp(inputGCPs, outputGCPs, inSlice, outSlice, rasNew);
+        return warp(inputGCPs, outputGCPs, inSlice, outSlice, rasNew, threads);
     }
     
     
@@ -302,7 +304,7 @@ namespace GeoStar {
     // THIS version of warp uses the TileIO, to handle reading in tiles of the input raster
     //  as needed:
     //template<typename T>
-    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, Raster *rasNew) {
+    Raster* Raster::warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, Raster *rasNew, const int threads) {
         // FORCE the number of ground control points to be ODD:
         int ngcp = (inputGCPs.size()/2) * 2;
         if (ngcp == inputGCPs.size()) ngcp--;
@@ -330,7 +332,7 @@ namespace GeoStar {
         //  old input coordinates:
         warpData.GCPRegression2D(rox, roy, rix, riy, &order, &rmsx, &rmsy);
         
-        return warp(warpData, inSlice, outSlice, rasNew);
+        return warp(warpData, inSlice, outSlice, rasNew, threads);
     }
 
     
@@ -343,44 +345,18 @@ namespace GeoStar {
     //
     // THIS version of warp uses the TileIO, to handle reading in tiles of the input raster
     //  as needed:
-    Raster* Raster::warp(const WarpParameters warpInfo, const Slice &in, const Slice &out, Raster *outRaster) {
+    Raster* Raster::warp(const WarpParameters warpInfo, const Slice &in, const Slice &out, Raster *outRaster, const int threads) {
         //RasterType  raster_datatype;
-        switch(raster_datatype) {
-            case INT8U:
-                //std::cout << " HERE B " << std::endl;
-                return warpType<uint8_t>(warpInfo, in, out, outRaster);
-                /*
-            case INT8S:
-                return warpType<int8_t>(warpInfo, in, out, outRaster);
-            case INT16U:
-                return warpType<uint16_t>(warpInfo, in, out, outRaster);
-            case INT16S:
-                return warpType<int16_t>(warpInfo, in, out, outRaster);
-            case INT32U:
-                return warpType<uint32_t>(warpInfo, in, out, outRaster);
-            case INT32S:
-                return warpType<int32_t>(warpInfo, in, out, outRaster);
-            case INT64U:
-                return warpType<uint64_t>(warpInfo, in, out, outRaster);
-            case INT64S:
-                 return warpType<int64_t>(warpInfo, in, out, outRaster);
-                 */
-            case REAL32:
-                //std::cout << "FLOAT TYPE ";
-                return warpType<float>(warpInfo, in, out, outRaster);
-            case REAL64:
-                return warpType<double>(warpInfo, in, out, outRaster);
-                //case COMPLEX_INT16:
-                //    return
-            default:
-                throw_RasterUnsupportedTypeError(fullRastername);
-        }
+        return visitRasterType(raster_datatype, [&](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return warpType<T>(warpInfo, in, out, outRaster, threads);
+        }, fullRastername);
 
     }
     
     
     template <typename T>
-    Raster* Raster::warpType(const WarpParameters warpInfo, const Slice &in, const Slice &out, Raster *outRaster) {
+    Raster* Raster::warpType(const WarpParameters warpInfo, const Slice &in, const Slice &out, Raster *outRaster, const int threads) {
 
         std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
         
@@ -484,98 +460,28 @@ namespace GeoStar {
         
         
         // RETRY (4th time?) AFTER FIXING A FEW MORE BUGS ...:
-        GeoStar::Slice tileDescriptor(0,0,8,8);     //  0.204849 / 0.212305 / 0.211564   (SAME)
-        int maxNumberSlicesInRam = 70;   // WAS ... 0.204153 / 0.237041 / 0.217582 / 0.211129
+        //GeoStar::Slice tileDescriptor(0,0,8,8);     //  0.204849 / 0.212305 / 0.211564   (SAME)
+        //int maxNumberSlicesInRam = 70;   // WAS ... 0.204153 / 0.237041 / 0.217582 / 0.211129
         // 0.182227 - 0.219794
-        // STILL POTENTIAL CHANGES TO SPEED TileIO (or could change name to "TileReader")
-        
-        
-        GeoStar::TileIO<T> reader(this, tileDescriptor, maxNumberSlicesInRam);
         
-        GeoStar::Slice scalingSlice(0,0,2,2,4);
-        
-        GeoStar::WarpParameters warpData = warpInfo;
-        GeoStar::Raster *rasNew = outRaster;
-        Slice sliceOut = out;
-        Slice sliceInput = in;
+        // NOW: no tiles at all.  The output is made a block (chunk) at a time, from one read of the input
+        //  window that the block maps to; see resampleEngine.
         long int xIn0 = in.getX0();
         long int yIn0 = in.getY0();
-        long int xInMax = xIn0 + in.getDeltaX();
-        long int yInMax = yIn0 + in.getDeltaY();
-        long int newDeltaY, newDeltaX;
-        newDeltaY = sliceOut.getDeltaY();
-        newDeltaX = sliceOut.getDeltaX();
-        long int xOut0 = sliceOut.getX0();
-        long int yOut0 = sliceOut.getY0();
-        long int xOutMax = xOut0 + newDeltaX;  // new
-        long int yOutMax = yOut0 + newDeltaY;  // new
-        
-        // TileIO will now handle reading input data.
-        std::vector<T> newData(newDeltaX);    // this will hold ONE ROW of the new image - output slice
-        double xScaled, yScaled;
-        long int oldY, oldX;
-        double xDiff, yDiff;
-        T pixelVal;
-        
-        GeoStar::Point pt;    // pt.x and pt.y are double
-        double yVal, xVal;
-        
-        //sliceInput.setDeltaY(3);
-        sliceOut.setDeltaY(1);
-        
-        double X, Y;
-        
-        //std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-        
-        for (long int i = yOut0; i < yOutMax; i++) {
-            yVal = static_cast<double>(i);
-            for (long int j = xOut0; j < xOutMax; j++) {
-                xVal = static_cast<double>(j);
-                
-                pt = warpData.GCPTransform(xVal, yVal);
-                xScaled = pt.getX() + xIn0;
-                
-                oldX = static_cast<long> (xScaled);
-                
-                xDiff = xScaled - static_cast<long>(oldX);
-                getNearest(oldX, xDiff);
-
-                if (oldX < xIn0) {
-                    newData[j] = 0;
-                    continue;
-                } else if (oldX >= xInMax) {
-                    newData[j] = 0;
-                    continue;
-                }
-
-                yScaled = pt.getY() + yIn0;
-                
-                oldY = static_cast<long> (yScaled);
-                
-                yDiff = yScaled - static_cast<long>(oldY);
-                getNearest(oldY, yDiff);
-
-                if (oldY < yIn0) {
-                    newData[j] = 0;
-                    continue;
-                } else if (oldY >= yInMax) {
-                    newData[j] = 0;
-                    continue;
-                }
-               
-                pixelVal = getScaledPixelFromTile<T>(oldY, oldX, xDiff, yDiff, sliceInput, scalingSlice, reader);
-                
-                newData[j] = pixelVal;
+        resampleEngine<T>(in, out, outRaster, [&](const long int &y, const long int &x0, const long int &n,
+                                                  double *xs, double *ys) {
+            warpInfo.GCPTransformRow(static_cast<double>(y), static_cast<double>(x0), n, xs, ys);
+            for (long int k = 0; k < n; k++) {
+                xs[k] += xIn0;
+                ys[k] += yIn0;
             }
-            sliceOut.setY0(i);
-            rasNew->write(sliceOut,newData);
-        }
+        }, threads);
         
         std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>( t2 - t1 ).count();
         std::cout << "warp execution duration: " << duration << std::endl;
         
-        return rasNew;
+        return outRaster;
     }
     
     
@@ -656,8 +562,15 @@ namespace GeoStar {
     }
 
     
-    template Raster* Raster::warpType<uint8_t>(const WarpParameters, const Slice&, const Slice&, Raster*);
-    template Raster* Raster::warpType<float>(const WarpParameters, const Slice&, const Slice&, Raster*);
-    template Raster* Raster::warpType<double>(const WarpParameters, const Slice&, const Slice&, Raster*);
+    template Raster* Raster::warpType<uint8_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<int8_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<uint16_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<int16_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<uint32_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<int32_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<uint64_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<int64_t>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<float>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
+    template Raster* Raster::warpType<double>(const WarpParameters, const Slice&, const Slice&, Raster*, const int);
 
 }// end namespace GeoStar
@@ -54,7 +54,7 @@ The constructors should only be called by the Image class: Image::createRaster.
       Raster* oldwarp(const WarpParameters warpData, const Slice &in, const Slice &out, Raster *outRaster);
 
       template <typename T>
-      Raster* warpType(const WarpParameters warpInfo, const Slice &in, const Slice &out, Raster *outRaster);
+      Raster* warpType(const WarpParameters warpInfo, const Slice &in, const Slice &out, Raster *outRaster, const int threads = 1);
       
 
   public:
@@ -126,24 +126,24 @@ The constructors should only be called by the Image class: Image::createRaster.
        */
       
       // Save this for testing later .... make sure still slower than specialized rotate()
-      Raster* rotateWithWarp(const float angle, const Slice &in);
+      Raster* rotateWithWarp(const float angle, const Slice &in, const int threads = 1);
 
       // warp #1:  calls warp #6
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const int threads = 1);
       // warp #2:  calls warp #6
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inslice);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inslice, const int threads = 1);
       // warp #3:  calls warp #6
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const std::string &name);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const std::string &name, const int threads = 1);
       // warp #4:  calls warp #6
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inslice, const std::string &name);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inslice, const std::string &name, const int threads = 1);
       // warp #5:  calls warp #6
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, Raster *rasNew);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, Raster *rasNew, const int threads = 1);
       // warp #6:  calls warp(warpInfo, inslice, outslice, rasNew)
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice inSlice, Raster *rasNew);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice inSlice, Raster *rasNew, const int threads = 1);
       // warp #7:  calls warp #8
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, const std::string &name);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, const std::string &name, const int threads = 1);
       // warp #8:  calls (warpInfo, inslice, outslice, rasNew)
-      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, Raster *rasNew);
+      Raster* warp(std::vector<Point> inputGCPs, std::vector<Point> outputGCPs, const Slice &inSlice, const Slice &outSlice, Raster *rasNew, const int threads = 1);
 
 
 
@@ -162,6 +162,9 @@ The constructors should only be called by the Image class: Image::createRaster.
        The output slice information - class type Slice.
    \param[in] newRaster
        The new Raster to write this warped raster to
+   \param[in] threads
+       The number of threads computing output blocks (0: one per core; default 1).  The blocks
+       are still written in order, from the calling thread.
 
    \returns
        new warped Raster.
@@ -231,7 +234,7 @@ The constructors should only be called by the Image class: Image::createRaster.
        \endcode
 
   */
-      Raster* warp(const WarpParameters warpData, const Slice &in, const Slice &out, Raster *outRaster);
+      Raster* warp(const WarpParameters warpData, const Slice &in, const Slice &out, Raster *outRaster, const int threads = 1);
 
 
 
@@ -0,0 +1,192 @@
+// SharedTileCache.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <functional>
+
+#include "SharedTileCache.hpp"
+
+namespace GeoStar {
+
+    const size_t SharedTileCache::DEFAULT_BUDGET;
+    const int SharedTileCache::SHARDS;
+
+
+    size_t SharedTileCache::KeyHash::operator()(const Key &key) const {
+        size_t h = std::hash<std::string>()(key.raster);
+        // boost::hash_combine:
+        h ^= std::hash<long int>()(key.x0) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<long int>()(key.y0) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<long int>()(key.nx) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<long int>()(key.ny) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<int>()(key.type) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }// end: KeyHash
+
+
+
+    SharedTileCache::SharedTileCache() : budget(DEFAULT_BUDGET) {
+        for (int s = 0; s < SHARDS; s++) shards[s].bytes = 0;
+    }
+
+
+
+    SharedTileCache &SharedTileCache::instance() {
+        // constructed on first use; thread-safe in C++11
+        static SharedTileCache cache;
+        return cache;
+    }
+
+
+
+    void SharedTileCache::drop(Shard &shard, const std::list<Entry>::iterator &it) {
+        shard.bytes -= it->bytes;
+        std::unordered_map<std::string, long int>::iterator count = shard.tilesPerRaster.find(it->key.raster);
+        if (count != shard.tilesPerRaster.end() && --count->second <= 0) shard.tilesPerRaster.erase(count);
+        shard.index.erase(it->key);
+        shard.lru.erase(it);
+    }// end: drop
+
+
+
+    void SharedTileCache::trim(Shard &shard, const size_t &shardBudget) {
+        while (shard.bytes > shardBudget && !shard.lru.empty()) {
+            std::list<Entry>::iterator last = shard.lru.end();
+            --last;
+            drop(shard, last);
+        }
+    }// end: trim
+
+
+
+    std::shared_ptr<void> SharedTileCache::findRaw(const Key &key) {
+        if (budget.load() == 0) return std::shared_ptr<void>();
+        Shard &shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash>::iterator it = shard.index.find(key);
+        if (it == shard.index.end()) return std::shared_ptr<void>();
+        // most recently used goes to the front:
+        if (it->second != shard.lru.begin())
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->data;
+    }// end: findRaw
+
+
+
+    void SharedTileCache::insertRaw(const Key &key, const std::shared_ptr<void> &data, const size_t &bytes) {
+        size_t shardBudget = budget.load() / SHARDS;
+        if (bytes == 0 || bytes > shardBudget) return;
+        Shard &shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash>::iterator it = shard.index.find(key);
+        if (it != shard.index.end()) drop(shard, it->second);
+
+        Entry entry;
+        entry.key = key;
+        entry.data = data;
+        entry.bytes = bytes;
+        shard.lru.push_front(entry);
+        shard.index[key] = shard.lru.begin();
+        shard.tilesPerRaster[key.raster]++;
+        shard.bytes += bytes;
+        trim(shard, shardBudget);
+    }// end: insertRaw
+
+
+
+    void SharedTileCache::invalidate(const std::string &raster, const long int &x0, const long int &y0,
+                                     const long int &nx, const long int &ny) {
+        for (int s = 0; s < SHARDS; s++) {
+            Shard &shard = shards[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            // nearly all writes are to rasters that have nothing cached (outputs):
+            if (shard.tilesPerRaster.find(raster) == shard.tilesPerRaster.end()) continue;
+            std::list<Entry>::iterator it = shard.lru.begin();
+            while (it != shard.lru.end()) {
+                std::list<Entry>::iterator next = it;
+                ++next;
+                const Key &key = it->key;
+                if (key.raster == raster && key.x0 < x0 + nx && x0 < key.x0 + key.nx
+                                         && key.y0 < y0 + ny && y0 < key.y0 + key.ny)
+                    drop(shard, it);
+                it = next;
+            }// endwhile
+        }// endfor: s
+    }// end: invalidate
+
+
+
+    void SharedTileCache::invalidate(const std::string &raster) {
+        for (int s = 0; s < SHARDS; s++) {
+            Shard &shard = shards[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.tilesPerRaster.find(raster) == shard.tilesPerRaster.end()) continue;
+            std::list<Entry>::iterator it = shard.lru.begin();
+            while (it != shard.lru.end()) {
+                std::list<Entry>::iterator next = it;
+                ++next;
+                if (it->key.raster == raster) drop(shard, it);
+                it = next;
+            }// endwhile
+        }// endfor: s
+    }// end: invalidate
+
+
+
+    void SharedTileCache::invalidatePrefix(const std::string &prefix) {
+        for (int s = 0; s < SHARDS; s++) {
+            Shard &shard = shards[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            bool any = false;
+            for (std::unordered_map<std::string, long int>::const_iterator r = shard.tilesPerRaster.begin();
+                 r != shard.tilesPerRaster.end() && !any; ++r)
+                any = (r->first.compare(0, prefix.size(), prefix) == 0);
+            if (!any) continue;
+            std::list<Entry>::iterator it = shard.lru.begin();
+            while (it != shard.lru.end()) {
+                std::list<Entry>::iterator next = it;
+                ++next;
+                if (it->key.raster.compare(0, prefix.size(), prefix) == 0) drop(shard, it);
+                it = next;
+            }// endwhile
+        }// endfor: s
+    }// end: invalidatePrefix
+
+
+
+    void SharedTileCache::clear() {
+        for (int s = 0; s < SHARDS; s++) {
+            Shard &shard = shards[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.lru.clear();
+            shard.index.clear();
+            shard.tilesPerRaster.clear();
+            shard.bytes = 0;
+        }// endfor: s
+    }// end: clear
+
+
+
+    void SharedTileCache::setBudget(const size_t &bytes) {
+        budget.store(bytes);
+        for (int s = 0; s < SHARDS; s++) {
+            Shard &shard = shards[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            trim(shard, bytes / SHARDS);
+        }// endfor: s
+    }// end: setBudget
+
+
+
+    size_t SharedTileCache::getBytes() {
+        size_t total = 0;
+        for (int s = 0; s < SHARDS; s++) {
+            std::lock_guard<std::mutex> lock(shards[s].mutex);
+            total += shards[s].bytes;
+        }// endfor: s
+        return total;
+    }// end: getBytes
+
+}// end namespace GeoStar
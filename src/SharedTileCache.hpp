@@ -0,0 +1,152 @@
+// SharedTileCache.hpp
+//
+//----------------------------------------
+#ifndef SHAREDTILECACHE_HPP_
+#define SHAREDTILECACHE_HPP_
+
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+
+
+namespace GeoStar {
+
+/** \brief SharedTileCache -- the process-wide cache of raster tiles read by TileIO.
+
+Every TileIO (the tile reader used by scale, the bitmap and polygon operations, ...) looks for its
+tiles here before reading them from the file, and puts the tiles it reads here; so do warp, rotate
+and reproject, for the input windows they resample from (TileIO::readWindow).  So successive operations on
+the same input raster, and operations running at the same time in other threads, read each tile
+from disk (and decompress it) only once, as long as it stays in the cache.
+
+\see TileIO, Raster
+
+\par Usage Overview
+There is one cache, SharedTileCache::instance().  Its size is limited by a byte budget
+(DEFAULT_BUDGET unless setBudget is called); the least recently used tiles are dropped when it is
+full.  A budget of 0 turns the cache off.
+
+\par Details
+Tiles are identified by the raster's full name (file, image and raster), the tile's window, and
+the pixel type they were read as.  Raster::write (and the other Raster methods that change
+pixels) drop the cached tiles that overlap what they change, so readers never see old pixels.
+Closing a File (deleting it) drops all its tiles, so a file made again under the same name does not
+see the tiles of the old one.
+
+The cache is split into SHARDS independent parts, each with its own lock, chosen by a hash of the
+tile, so threads working on different tiles rarely wait for each other.  The tile data is shared,
+not copied: a tile dropped from the cache stays valid for the readers that still hold it.
+*/
+  class SharedTileCache {
+
+  public:
+      // identifies a tile
+      struct Key {
+          std::string raster;     // full raster name
+          long int x0, y0;        // the tile's window
+          long int nx, ny;
+          int type;               // the RasterType the pixels were read as
+
+          inline bool operator==(const Key &other) const {
+              return x0 == other.x0 && y0 == other.y0 && nx == other.nx && ny == other.ny
+                  && type == other.type && raster == other.raster;
+          }
+      };
+
+      struct KeyHash {
+          size_t operator()(const Key &key) const;
+      };
+
+      static const size_t DEFAULT_BUDGET = 268435456;   // 256 MiB
+      static const int SHARDS = 16;
+
+  private:
+      struct Entry {
+          Key key;
+          std::shared_ptr<void> data;     // a std::vector<T>, T given by key.type
+          size_t bytes;
+      };
+
+      // one independently locked part of the cache: an LRU list (most recent first) and its index
+      struct Shard {
+          std::mutex mutex;
+          std::list<Entry> lru;
+          std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+          std::unordered_map<std::string, long int> tilesPerRaster;   // lets writes skip shards
+          size_t bytes;
+      };
+
+      Shard shards[SHARDS];
+      std::atomic<size_t> budget;
+
+      SharedTileCache();
+      SharedTileCache(const SharedTileCache &) = delete;
+      SharedTileCache &operator=(const SharedTileCache &) = delete;
+
+      inline Shard &shardFor(const Key &key) {
+          return shards[KeyHash()(key) % SHARDS];
+      }
+
+      // drop entries from the end of the shard's list until it is within its share of the budget
+      //  (the shard's mutex must be held)
+      void trim(Shard &shard, const size_t &shardBudget);
+
+      // drop one entry (the shard's mutex must be held)
+      void drop(Shard &shard, const std::list<Entry>::iterator &it);
+
+      std::shared_ptr<void> findRaw(const Key &key);
+      void insertRaw(const Key &key, const std::shared_ptr<void> &data, const size_t &bytes);
+
+  public:
+      // the process-wide cache
+      static SharedTileCache &instance();
+
+      // the cached tile, or an empty pointer.  The vector must not be changed.
+      template <typename T>
+      inline std::shared_ptr<std::vector<T> > find(const Key &key) {
+          return std::static_pointer_cast<std::vector<T> >(findRaw(key));
+      }
+
+      // adds a tile (replacing any tile with the same key).  The vector must not be changed afterwards.
+      template <typename T>
+      inline void insert(const Key &key, const std::shared_ptr<std::vector<T> > &data) {
+          insertRaw(key, data, data->size() * sizeof(T));
+      }
+
+      // drops the tiles of the raster that overlap the window x0, y0, nx X ny
+      void invalidate(const std::string &raster, const long int &x0, const long int &y0,
+                      const long int &nx, const long int &ny);
+
+      // drops all tiles of the raster
+      void invalidate(const std::string &raster);
+
+      // drops all tiles of the rasters whose full names start with prefix (a file's name and "/":
+      //  all the file's tiles, see File::~File)
+      void invalidatePrefix(const std::string &prefix);
+
+      // drops all tiles
+      void clear();
+
+      // set the budget, in bytes (0 turns the cache off); tiles are dropped if needed
+      void setBudget(const size_t &bytes);
+
+      // return the budget, in bytes
+      inline size_t getBudget() const {
+          return budget.load();
+      }
+
+      // return the size of the cached tiles, in bytes
+      size_t getBytes();
+
+  }; // end class: SharedTileCache
+
+}// end namespace GeoStar
+
+
+#endif //SHAREDTILECACHE_HPP_
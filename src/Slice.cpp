@@ -32,11 +32,7 @@ namespace GeoStar {
       this->strideX = strideX;
       this->strideY = strideY;
       if (numberPixels <= 0) {
-          int numberXPixels = deltaX;
-          if (strideX != 1) numberXPixels /= strideX;
-          int numberYPixels = deltaY;
-          if (strideY != 1) numberYPixels /= strideY;
-          this->numberPixels = numberXPixels * numberYPixels;
+          this->numberPixels = getCountX() * getCountY();
       } else this->numberPixels = numberPixels;
       /*
       if (numberPixels == 0) {
@@ -64,25 +60,25 @@ namespace GeoStar {
     // set delta-x
     void Slice::setDeltaX(const long int &deltaX) {
         this->deltaX = deltaX;
-        this->numberPixels = deltaX*deltaY;
+        this->numberPixels = getCountX()*getCountY();
     }
     
     // set delta-y
     void Slice::setDeltaY(const long int &deltaY) {
         this->deltaY = deltaY;
-        this->numberPixels = deltaX*deltaY;
+        this->numberPixels = getCountX()*getCountY();
     }
     
     // set stride-x
     void Slice::setStrideX(const long int &strideX) {
         this->strideX = strideX;
-        this->numberPixels = deltaX*deltaY;
+        this->numberPixels = getCountX()*getCountY();
     }
     
     // set stride-y
     void Slice::setStrideY(const long int &strideY) {
         this->strideY = strideY;
-        this->numberPixels = deltaX*deltaY;
+        this->numberPixels = getCountX()*getCountY();
     }
 
     
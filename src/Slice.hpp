@@ -54,15 +54,28 @@ namespace GeoStar {
       }
       
       // return strideX
-      inline long int getStrideX() {
+      inline long int getStrideX() const {
           return strideX;
       }
       
       // return strideY
-      inline long int getStrideY() {
+      inline long int getStrideY() const {
           return strideY;
       }
       
+      // return the number of pixels selected in the x-direction: every strideX'th pixel
+      //  of the deltaX pixels, starting at x0 (a stride of 0 or 1 selects all of them)
+      inline long int getCountX() const {
+          long int sx = (strideX > 1) ? strideX : 1;
+          return (deltaX > 0) ? (deltaX + sx - 1) / sx : 0;
+      }
+      
+      // return the number of pixels selected in the y-direction
+      inline long int getCountY() const {
+          long int sy = (strideY > 1) ? strideY : 1;
+          return (deltaY > 0) ? (deltaY + sy - 1) / sy : 0;
+      }
+      
       // return numberPixels
       inline long int getNumberPixels()  const {
           return numberPixels;
@@ -10,6 +10,10 @@
 #include <vector>
 #include <array>
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
 
 #include "geostar.hpp"
 #include "Slice.hpp"
@@ -17,9 +21,116 @@
 
 namespace GeoStar {
     
+    template <class T>
+    const size_t TileIO<T>::DEFAULT_MEMORY_BUDGET;
+
+
+
     template <class T>
     TileIO<T>::TileIO(Raster *raster, const Slice &tileDescriptor, const int &maxNumberTiles) {
         this->raster = raster;
+        init(tileDescriptor, maxNumberTiles);
+    }// end-TileIO-constructor
+
+
+
+    template <class T>
+    TileIO<T>::TileIO(Raster *raster, const long int &footprintX, const long int &footprintY,
+                      const size_t &memoryBudget) {
+        this->raster = raster;
+        long int nx = std::max(1L, raster->get_nx());
+        long int ny = std::max(1L, raster->get_ny());
+        long int cx, cy;
+        tileSize(raster, cx, cy, memoryBudget);
+        size_t budget = std::max(memoryBudget, (size_t)65536);
+
+        // enough tiles to cover the footprint wherever it falls (+1 each way), twice, so the
+        //  tiles of the next step fit too; no more than the budget holds:
+        long int fx = std::max(1L, std::min(footprintX, nx));
+        long int fy = std::max(1L, std::min(footprintY, ny));
+        long int wanted = 2 * ((fx + cx - 1) / cx + 1) * ((fy + cy - 1) / cy + 1);
+        long int fit = budget / ((size_t)(cx * cy) * sizeof(T));
+        int maxNumberTiles = (int)std::max(4L, std::min(wanted, fit));
+
+        init(Slice(0, 0, cx, cy), maxNumberTiles);
+    }// end-TileIO-constructor
+
+
+
+    template <class T>
+    void TileIO<T>::tileSize(const Raster *raster, long int &cx, long int &cy, const size_t &memoryBudget) {
+        long int nx = std::max(1L, raster->get_nx());
+        long int ny = std::max(1L, raster->get_ny());
+
+        // tiles are whole chunks:
+        if (!raster->getChunkSize(cx, cy)) {
+            cx = 256;
+            cy = 256;
+        }
+        // ... several chunks, if they are tiny (reads have a fixed cost), ...
+        while (cx * cy < 4096 && (cx < nx || cy < ny)) {
+            if (cx <= cy && cx < nx) cx *= 2;
+            else cy *= 2;
+        }
+        cx = std::min(cx, nx);
+        cy = std::min(cy, ny);
+        // ... or parts of a chunk, if one chunk would take more than 1/8 of the budget:
+        size_t budget = std::max(memoryBudget, (size_t)65536);
+        while ((size_t)(cx * cy) * sizeof(T) > budget / 8 && (cx > 16 || cy > 16)) {
+            if (cx >= cy) cx = (cx + 1) / 2;
+            else cy = (cy + 1) / 2;
+        }
+    }// end: tileSize
+
+
+
+    template <class T>
+    void TileIO<T>::readWindow(const Raster *raster, const Slice &window, T *out, std::mutex &io) {
+        SharedTileCache &cache = SharedTileCache::instance();
+        if (cache.getBudget() == 0) {
+            // nothing would be kept: read just the window
+            std::lock_guard<std::mutex> lock(io);
+            raster->read(window, out);
+            return;
+        }
+
+        long int cx, cy;
+        tileSize(raster, cx, cy, DEFAULT_MEMORY_BUDGET);
+        long int nx = raster->get_nx(), ny = raster->get_ny();
+        long int wx0 = window.getX0(), wy0 = window.getY0();
+        long int wx1 = wx0 + window.getDeltaX(), wy1 = wy0 + window.getDeltaY();
+        long int ww = window.getDeltaX();
+
+        for (long int ty0 = (wy0 / cy) * cy; ty0 < wy1; ty0 += cy) {
+            for (long int tx0 = (wx0 / cx) * cx; tx0 < wx1; tx0 += cx) {
+                Slice tileSlice(tx0, ty0, std::min(cx, nx - tx0), std::min(cy, ny - ty0));
+                SharedTileCache::Key key = keyFor(raster, tileSlice);
+                std::shared_ptr<std::vector<T> > tile = cache.find<T>(key);
+                if (!tile) {
+                    tile = std::make_shared<std::vector<T> >(tileSlice.getDeltaX() * tileSlice.getDeltaY());
+                    {
+                        std::lock_guard<std::mutex> lock(io);
+                        raster->read(tileSlice, *tile);
+                    }
+                    cache.insert<T>(key, tile);
+                }
+
+                // the part of the tile in the window:
+                long int tnx = tileSlice.getDeltaX();
+                long int x0 = std::max(tx0, wx0), x1 = std::min(tx0 + tnx, wx1);
+                long int y0 = std::max(ty0, wy0), y1 = std::min(ty0 + tileSlice.getDeltaY(), wy1);
+                for (long int y = y0; y < y1; y++) {
+                    const T *from = tile->data() + (y - ty0) * tnx + (x0 - tx0);
+                    std::copy(from, from + (x1 - x0), out + (y - wy0) * ww + (x0 - wx0));
+                }// endfor: y
+            }// endfor: tx0
+        }// endfor: ty0
+    }// end: readWindow
+
+
+
+    template <class T>
+    void TileIO<T>::init(const Slice &tileDescriptor, const int &maxNumberTiles) {
         this->tileDescriptor = tileDescriptor;
         this->maxNumberTiles = maxNumberTiles;
         rasterWidth = raster->get_nx();
@@ -32,11 +143,38 @@ namespace GeoStar {
         numberYTiles = (int) floor(rasterHeight * yScale);
         if ((numberYTiles*tileDescriptor.getDeltaY()) != rasterHeight) numberYTiles++;
         oneOverNumberXTiles = 1.0 / numberXTiles;
-        timer = 0;
-    }// end-TileIO-constructor
-    
-    
-    
+        tileIndex.reserve(2 * std::max(1, maxNumberTiles));
+        lastTile = NULL;
+
+        prefetchDepth = 2;
+        dirX = 0;
+        dirY = 0;
+        lastMissX = -1;
+        lastMissY = -1;
+        lastStepX = 0;
+        lastStepY = 0;
+        stopping = false;
+        // a background reader needs a thread-safe HDF5 library:
+        hbool_t threadsafe = false;
+        threaded = (H5is_library_threadsafe(&threadsafe) >= 0 && threadsafe);
+    }// end: init
+
+
+
+    template <class T>
+    TileIO<T>::~TileIO() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(prefetchMutex);
+                stopping = true;
+            }
+            prefetchWake.notify_all();
+            worker.join();
+        }
+    }// end-TileIO-destructor
+
+
+
     //change Slice to have TOTAL#PIXELS (set to deltaX*deltaY) ... so don't have to continually multiply here
     template <class T>
     std::vector<T> TileIO<T>::tileRead(const Slice &pixelsToReadIn) {
@@ -52,192 +190,379 @@ namespace GeoStar {
         if (minX < 0) {
             throw_SliceDataError("negative x0 Slice value");
             //return data;
-        } else if (maxX > rasterWidth) {
+        } else if (maxX >= rasterWidth) {
             throw_SliceDataError("delta-x Slice value beyond raster width");
             //return data;
         } else if (minY < 0) {
             throw_SliceDataError("negative y0 Slice value");
             //return data;
-        } else if (maxY > rasterHeight) {
+        } else if (maxY >= rasterHeight) {
             throw_SliceDataError("delta-y Slice value beyond raster height");
             //return data;
         }
-        std::map<int, long int>::iterator it;     // <tile#,timer>  (timer = last accessed time)
-        
-        int yTile, xTile;
-        xTile = minX * xScale;
-        yTile = minY * yScale;
-        int tileNeeded = xTile + (yTile * numberXTiles);
-        
-        int previousTileNumber = tileNeeded;
-        
-        Tile<T> currentTile = verifyNeededTileIsAvailable(tileNeeded);
-        Tile<T> originalTile = currentTile;
-        int originalTileNeeded = tileNeeded;
-        
-        int x0 = currentTile.slice.getX0();
-        int y0 = currentTile.slice.getY0();
-        int tileWidth = currentTile.slice.getDeltaX();  // can be smaller than normal slice width, if @ end
-        int tileHeight = currentTile.slice.getDeltaY();  //   "   slice height "
-        
-        int x,y,n,timer;
-        n = 0;
-        
-        bool xTilec, yTilec;
-        xTilec = false;
 
+        // each row of the slice is copied one tile-wide run at a time, straight from the cached
+        //  tile (which stays valid until the next tile is looked up):
+        int n = 0;
         for (int j = minY; j <= maxY; j++) {
-            yTilec = false;
-            // If xtile needed was changed, (at most ONCE for now, since only reading at most 2X2 pixels!!)
-            //   during reading x values, reset the tile to the previous one, to continue reading
-            //   the y values:
-            if (xTilec) {
-                currentTile = originalTile;
-                tileNeeded = originalTileNeeded;
-                x0 = currentTile.slice.getX0();
-                y0 = currentTile.slice.getY0();
-                tileWidth = currentTile.slice.getDeltaX();
-                tileHeight = currentTile.slice.getDeltaY();
-            }
-            xTilec = false;
-            // "while" for possible future cases where many pixels are to be read, possibly spanning
-            //  more tiles than 2X2 (Max for reading up to 4 pixels):
-            while (j > (y0 + tileHeight - 1)) {
-                yTilec = true;
-                tileNeeded += numberXTiles;
-                // set the last accessed time for the previous tile
-                it = lastAccessTimes.find(previousTileNumber);
-                if (it != lastAccessTimes.end())
-                    lastAccessTimes[previousTileNumber] = timer;
-                previousTileNumber = tileNeeded;
-                // Read in next needed tile, if NOT already available in Tile heap (map)
-                currentTile = verifyNeededTileIsAvailable(tileNeeded);
-                x0 = currentTile.slice.getX0();
-                y0 = currentTile.slice.getY0();
-                tileWidth = currentTile.slice.getDeltaX();
-                tileHeight = currentTile.slice.getDeltaY();
-            }
-            y = j - y0;
-            for (int i = minX; i <= maxX; i++) {
-                // "while" for possible future cases where many pixels are to be read, possibly spanning
-                //  more tiles than 2X2 (Max for reading up to 4 pixels):
-                while (i > (x0 + tileWidth - 1)) {
-                    xTilec = true;
-                    tileNeeded++;
-                    // set the last accessed time for the previous tile
-                    it = lastAccessTimes.find(previousTileNumber);
-                    if (it != lastAccessTimes.end())
-                        lastAccessTimes[previousTileNumber] = timer;
-                    previousTileNumber = tileNeeded;
-                    // Read in next needed tile, if NOT already available in Tile heap (map)
-                    currentTile = verifyNeededTileIsAvailable(tileNeeded);
-                    x0 = currentTile.slice.getX0();
-                    y0 = currentTile.slice.getY0();
-                    tileWidth = currentTile.slice.getDeltaX();
-                    tileHeight = currentTile.slice.getDeltaY();
+            int yTile = j * yScale;
+            int i = minX;
+            while (i <= maxX) {
+                int xTile = i * xScale;
+                Tile<T> &tile = verifyNeededTileIsAvailable(xTile + (yTile * numberXTiles));
+                int x0 = tile.slice.getX0();
+                int xEnd = std::min(maxX, x0 + tile.sliceWidth - 1);
+                const T *row = &tile.data[(j - tile.slice.getY0()) * tile.sliceWidth];
+                for (; i <= xEnd; i++) {
+                    data[n] = row[i - x0];
+                    n++;
                 }
-                x = i - x0;
-                data[n] = currentTile.data[x+(y*tileWidth)];
-                n++;
-                // Update access info:
-                timer++;
             }
         }
-        // Update most recent tile used (last-accessed-time)
-        it = lastAccessTimes.find(tileNeeded);
-        if (it != lastAccessTimes.end())
-            lastAccessTimes[tileNeeded] = timer;
 
         return data;
     }
 
+
+
+    template <class T>
+    void TileIO<T>::findTile(const long int &x, const long int &y) {
+        if (x < 0 || x >= rasterWidth || y < 0 || y >= rasterHeight)
+            throw_SliceDataError("pixel outside raster");
+        int xTile = x * xScale;
+        int yTile = y * yScale;
+        lastTile = &verifyNeededTileIsAvailable(xTile + (yTile * numberXTiles));
+    }
+
+
+
+    template <class T>
+    void TileIO<T>::neighborhood(const long int &x, const long int &y, const long int &w, const long int &h, T *out) {
+        if (!inLastTile(x, y, w, h)) {
+            if (x < 0 || x + w > rasterWidth || y < 0 || y + h > rasterHeight)
+                throw_SliceDataError("neighborhood outside raster");
+            findTile(x, y);
+        }
+
+        if (inLastTile(x, y, w, h)) {
+            // all in one tile:
+            const T *row = &lastTile->data[(y - lastTile->slice.getY0()) * lastTile->sliceWidth
+                                           + (x - lastTile->slice.getX0())];
+            for (long int j = 0; j < h; j++) {
+                for (long int i = 0; i < w; i++) out[i] = row[i];
+                out += w;
+                row += lastTile->sliceWidth;
+            }
+            return;
+        }
+
+        // across tile edges: pixel by pixel (at most 4 tiles for a 2x2 neighborhood)
+        for (long int j = 0; j < h; j++)
+            for (long int i = 0; i < w; i++)
+                *out++ = at(x + i, y + j);
+    }
+
+
+
+    template <class T>
+    PinnedTile<T> TileIO<T>::tileAt(const long int &x, const long int &y) {
+        if (x < 0 || x >= rasterWidth || y < 0 || y >= rasterHeight)
+            throw_SliceDataError("pixel outside raster");
+        int xTile = x * xScale;
+        int yTile = y * yScale;
+        return PinnedTile<T>(verifyNeededTileIsAvailable(xTile + (yTile * numberXTiles)));
+    }
+
     
     
     template <class T>
-    Tile<T> TileIO<T>::verifyNeededTileIsAvailable(const int &tileNeeded) {
-        typename std::map<int,Tile<T> >::iterator it;
-        it = tiles.find(tileNeeded);
-        if (it == tiles.end()) {
+    Tile<T> &TileIO<T>::verifyNeededTileIsAvailable(const int &tileNeeded) {
+        typename std::unordered_map<int, typename std::list<Tile<T> >::iterator>::iterator it;
+        it = tileIndex.find(tileNeeded);
+        if (it == tileIndex.end()) {
             readInNeededTile(tileNeeded);
-            it = tiles.find(tileNeeded);
+            return tiles.front();
         }
-        return it->second;
+        // most recently used goes to the front (no copy: the list node moves):
+        if (it->second != tiles.begin())
+            tiles.splice(tiles.begin(), tiles, it->second);
+        return *it->second;
     }
      
     
     
     template <class T>
-    void TileIO<T>::readInNeededTile(int tileNumber) {
-        int x0, y0, deltaX, deltaY;
-
-        int yTileNumber = (int) (tileNumber * oneOverNumberXTiles);
+    Slice TileIO<T>::tileSliceFor(const int &tileNumber) const {
+        int yTileNumber = tileNumber / numberXTiles;
         int xTileNumber = tileNumber - (yTileNumber * numberXTiles);
-        deltaX = tileDescriptor.getDeltaX();
-        deltaY = tileDescriptor.getDeltaY();
-        x0 = xTileNumber * deltaX;
-        y0 = yTileNumber * deltaY;
+        int deltaX = tileDescriptor.getDeltaX();
+        int deltaY = tileDescriptor.getDeltaY();
+        int x0 = xTileNumber * deltaX;
+        int y0 = yTileNumber * deltaY;
         
         // For possible fractional-sized tiles at right / bottom of raster:
-        if ((x0 + deltaX - 1) >= raster->get_nx())
-            deltaX = raster->get_nx() - x0;
-        if ((y0 + deltaY - 1) >= raster->get_ny())
-            deltaY = raster->get_ny() - y0;
-        
-        Slice tileSlice(x0,y0,deltaX,deltaY);
+        if ((x0 + deltaX - 1) >= rasterWidth)
+            deltaX = rasterWidth - x0;
+        if ((y0 + deltaY - 1) >= rasterHeight)
+            deltaY = rasterHeight - y0;
         
-        // DIES at this call below (Tile constructor ...)
-        Tile<T> newTile(tileSlice);
+        return Slice(x0,y0,deltaX,deltaY);
+    }
+
+
 
-        // Throw out the least recently accessed tile, if we're at the maximum number of tiles:
-        if (tiles.size() >= maxNumberTiles)
+    template <class T>
+    SharedTileCache::Key TileIO<T>::keyFor(const Raster *raster, const Slice &tileSlice) {
+        SharedTileCache::Key key;
+        key.raster = raster->getFullRasterName();
+        key.x0 = tileSlice.getX0();
+        key.y0 = tileSlice.getY0();
+        key.nx = tileSlice.getDeltaX();
+        key.ny = tileSlice.getDeltaY();
+        key.type = RasterTypeOf<T>::value;
+        return key;
+    }
+
+
+
+    template <class T>
+    void TileIO<T>::addTile(const int &tileNumber, const Slice &tileSlice, const std::shared_ptr<std::vector<T> > &buffer) {
+        // Throw out the least recently accessed tile, if we're at the maximum number of tiles
+        //  (its buffer goes to the pool, for the next tile):
+        if ((int)tiles.size() >= maxNumberTiles)
             throwOutLeastUsedTile();
-        raster->read(tileSlice, newTile.data);
-        tiles[tileNumber] = newTile;
-        return;
+
+        Slice slice = tileSlice;
+        tiles.push_front(Tile<T>(slice, buffer));
+        tiles.front().tileNumber = tileNumber;
+        tileIndex[tileNumber] = tiles.begin();
     }
     
     
     
     template <class T>
-    void TileIO<T>::throwOutLeastUsedTile() {
-        typename std::map<int, Tile<T> >::iterator itTiles = tiles.begin();
-        int tileNumber = itTiles->first;
-        Tile<T> tile = itTiles->second;
-        
-        std::map<int, long int>::iterator itAccessTimes;
+    void TileIO<T>::readInNeededTile(int tileNumber) {
+        Slice tileSlice = tileSliceFor(tileNumber);
+        int tileX = tileNumber % numberXTiles;
+        int tileY = tileNumber / numberXTiles;
+        noteMiss(tileX, tileY);
 
-        long int timestamp = 0;
-        itAccessTimes = lastAccessTimes.find(tileNumber);
-        if (itAccessTimes != lastAccessTimes.end())
-            timestamp = itAccessTimes->second;
-        
-        long int timestampMin = timestamp;
-        int tileMinNumber = tileNumber;
-        Tile<T> tileMin;
-        itTiles++;
-        while (itTiles != tiles.end()) {
-            tileNumber = itTiles->first;
-            tile = itTiles->second;
-            
-            timestamp = 0;
-            itAccessTimes = lastAccessTimes.find(tileNumber);
-            if (itAccessTimes != lastAccessTimes.end())
-                timestamp = itAccessTimes->second;
-            
-            if (timestamp < timestampMin) {
-                timestampMin = timestamp;
-                tileMinNumber = tileNumber;
+        // the prefetch thread may have it (or be reading it); else another TileIO (an earlier
+        //  operation, or another thread) may have read it already:
+        std::shared_ptr<std::vector<T> > buffer;
+        if (threaded) buffer = takePrefetched(tileNumber);
+        SharedTileCache::Key key = keyFor(raster, tileSlice);
+        if (!buffer) buffer = SharedTileCache::instance().find<T>(key);
+
+        if (buffer) {
+            addTile(tileNumber, tileSlice, buffer);
+        } else if (!threaded && readAhead(tileNumber)) {
+            // read together with the tiles ahead of it, and already added
+        } else {
+            if (bufferPool.empty()) {
+                buffer = std::make_shared<std::vector<T> >();
+            } else {
+                buffer = bufferPool.back();
+                bufferPool.pop_back();
             }
-            itTiles++;
+            buffer->resize(tileSlice.getDeltaX() * tileSlice.getDeltaY());
+            raster->read(tileSlice, *buffer);
+            SharedTileCache::instance().insert<T>(key, buffer);
+            addTile(tileNumber, tileSlice, buffer);
         }
-        
-        tiles.erase(tileMinNumber);
-        lastAccessTimes.erase(tileMinNumber);
+
+        if (threaded) schedulePrefetch(tileX, tileY);
         return;
     }
+
+
+
+    template <class T>
+    void TileIO<T>::noteMiss(const int &tileX, const int &tileY) {
+        int stepX = tileX - lastMissX;
+        int stepY = tileY - lastMissY;
+        // the same single-tile step twice in a row sets the direction:
+        if (lastMissX >= 0 && stepX == lastStepX && stepY == lastStepY
+            && std::abs(stepX) <= 1 && std::abs(stepY) <= 1 && (stepX != 0 || stepY != 0)) {
+            if (stepX != dirX || stepY != dirY) {
+                std::lock_guard<std::mutex> lock(prefetchMutex);
+                // tiles read ahead in the old direction won't be wanted:
+                prefetchQueue.clear();
+                prefetched.clear();
+            }
+            dirX = stepX;
+            dirY = stepY;
+        }
+        lastStepX = stepX;
+        lastStepY = stepY;
+        lastMissX = tileX;
+        lastMissY = tileY;
+    }
+
+
+
+    template <class T>
+    void TileIO<T>::schedulePrefetch(const int &tileX, const int &tileY) {
+        if (prefetchDepth == 0 || (dirX == 0 && dirY == 0)) return;
+
+        bool added = false;
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex);
+            for (int k = 1; k <= prefetchDepth; k++) {
+                int x = tileX + k*dirX;
+                int y = tileY + k*dirY;
+                if (x < 0 || x >= numberXTiles || y < 0 || y >= numberYTiles) break;
+                int tileNumber = x + y*numberXTiles;
+                if (tileIndex.count(tileNumber) || prefetchPending.count(tileNumber) || prefetched.count(tileNumber))
+                    continue;
+                // the worker's results are limited to one cache's worth of tiles:
+                if ((int)(prefetched.size() + prefetchPending.size()) >= maxNumberTiles) break;
+                prefetchQueue.push_back(tileNumber);
+                prefetchPending.insert(tileNumber);
+                added = true;
+            }// endfor: k
+        }
+        if (!added) return;
+        if (!worker.joinable()) worker = std::thread(&TileIO<T>::prefetchLoop, this);
+        prefetchWake.notify_one();
+    }
+
+
+
+    template <class T>
+    void TileIO<T>::prefetchLoop() {
+        std::unique_lock<std::mutex> lock(prefetchMutex);
+        while (true) {
+            prefetchWake.wait(lock, [this] { return stopping || !prefetchQueue.empty(); });
+            if (stopping) return;
+            int tileNumber = prefetchQueue.front();
+            prefetchQueue.pop_front();
+            lock.unlock();
+
+            Slice tileSlice = tileSliceFor(tileNumber);
+            SharedTileCache::Key key = keyFor(raster, tileSlice);
+            std::shared_ptr<std::vector<T> > buffer = SharedTileCache::instance().find<T>(key);
+            if (!buffer) {
+                try {
+                    buffer = std::make_shared<std::vector<T> >(tileSlice.getDeltaX() * tileSlice.getDeltaY());
+                    raster->read(tileSlice, *buffer);
+                    SharedTileCache::instance().insert<T>(key, buffer);
+                } catch (...) {
+                    // the reader will read it (and see the error) itself
+                    buffer.reset();
+                }
+            }
+
+            lock.lock();
+            if (buffer) prefetched[tileNumber] = buffer;
+            prefetchPending.erase(tileNumber);
+            prefetchDone.notify_all();
+        }// endwhile
+    }
+
+
+
+    template <class T>
+    std::shared_ptr<std::vector<T> > TileIO<T>::takePrefetched(const int &tileNumber) {
+        std::unique_lock<std::mutex> lock(prefetchMutex);
+        if (prefetchPending.count(tileNumber)) {
+            // still queued: read it here instead; being read: wait for it
+            std::deque<int>::iterator queued = std::find(prefetchQueue.begin(), prefetchQueue.end(), tileNumber);
+            if (queued != prefetchQueue.end()) {
+                prefetchQueue.erase(queued);
+                prefetchPending.erase(tileNumber);
+                return std::shared_ptr<std::vector<T> >();
+            }
+            prefetchDone.wait(lock, [this, tileNumber] { return prefetchPending.count(tileNumber) == 0; });
+        }
+        typename std::unordered_map<int, std::shared_ptr<std::vector<T> > >::iterator it = prefetched.find(tileNumber);
+        if (it == prefetched.end()) return std::shared_ptr<std::vector<T> >();
+        std::shared_ptr<std::vector<T> > buffer = it->second;
+        prefetched.erase(it);
+        return buffer;
+    }
+
+
+
+    template <class T>
+    bool TileIO<T>::readAhead(const int &tileNumber) {
+        // only along a row or a column of tiles, where the tiles ahead make one window:
+        if (prefetchDepth == 0 || (dirX != 0) == (dirY != 0)) return false;
+
+        int tileX = tileNumber % numberXTiles;
+        int tileY = tileNumber / numberXTiles;
+        int first = tileNumber, last = tileNumber, count = 1;
+        for (int k = 1; k <= prefetchDepth; k++) {
+            int x = tileX + k*dirX;
+            int y = tileY + k*dirY;
+            if (x < 0 || x >= numberXTiles || y < 0 || y >= numberYTiles) break;
+            int next = x + y*numberXTiles;
+            if (tileIndex.count(next)) break;
+            first = std::min(first, next);
+            last = std::max(last, next);
+            count++;
+        }// endfor: k
+        // keep room for the tiles in use:
+        count = std::min(count, std::max(1, maxNumberTiles/2));
+        if (count < 2) return false;
+        if (dirX < 0 || dirY < 0) first = tileNumber - (count-1) * (dirX != 0 ? 1 : numberXTiles);
+        else last = tileNumber + (count-1) * (dirX != 0 ? 1 : numberXTiles);
+
+        // one read of the window of all of them, split into tiles:
+        Slice firstSlice = tileSliceFor(first);
+        Slice lastSlice = tileSliceFor(last);
+        long int wx0 = firstSlice.getX0();
+        long int wy0 = firstSlice.getY0();
+        long int wnx = lastSlice.getX0() + lastSlice.getDeltaX() - wx0;
+        Slice window(wx0, wy0, wnx, lastSlice.getY0() + lastSlice.getDeltaY() - wy0);
+        std::vector<T> pixels;
+        raster->read(window, pixels);
+
+        int step = (dirX != 0) ? 1 : numberXTiles;
+        // the needed tile goes in last, so it is the most recently used:
+        for (int t = (tileNumber == first) ? last : first; ; t += (tileNumber == first) ? -step : step) {
+            Slice tileSlice = tileSliceFor(t);
+            std::shared_ptr<std::vector<T> > buffer = std::make_shared<std::vector<T> >(tileSlice.getDeltaX() * tileSlice.getDeltaY());
+            long int ox = tileSlice.getX0() - wx0;
+            long int oy = tileSlice.getY0() - wy0;
+            for (long int j = 0; j < tileSlice.getDeltaY(); j++)
+                std::copy(&pixels[(oy + j)*wnx + ox], &pixels[(oy + j)*wnx + ox] + tileSlice.getDeltaX(),
+                          &(*buffer)[j*tileSlice.getDeltaX()]);
+            SharedTileCache::instance().insert<T>(keyFor(raster, tileSlice), buffer);
+            if (!tileIndex.count(t)) addTile(t, tileSlice, buffer);
+            if (t == tileNumber) break;
+        }// endfor: t
+        return true;
+    }
+    
+    
+    
+    template <class T>
+    bool TileIO<T>::throwOutLeastUsedTile() {
+        // the least recently used tile is at the back; skip any that a caller has pinned:
+        typename std::list<Tile<T> >::iterator it = tiles.end();
+        while (it != tiles.begin()) {
+            --it;
+            if (it->pins > 0) continue;
+            if (&*it == lastTile) lastTile = NULL;
+            tileIndex.erase(it->tileNumber);
+            // a buffer that is also in the shared cache stays there; only private ones are re-used:
+            if (it->buffer.use_count() == 1) bufferPool.push_back(it->buffer);
+            tiles.erase(it);
+            return true;
+        }
+        return false;
+    }
     
     // explicit instantiations
     template class TileIO<uint8_t>;
+    template class TileIO<int8_t>;
+    template class TileIO<uint16_t>;
+    template class TileIO<int16_t>;
+    template class TileIO<uint32_t>;
+    template class TileIO<int32_t>;
+    template class TileIO<uint64_t>;
+    template class TileIO<int64_t>;
     template class TileIO<float>;
     template class TileIO<double>;
 
@@ -9,7 +9,16 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 #include "H5Cpp.h"
@@ -20,6 +29,7 @@
 #include "RasterType.hpp"
 #include "attributes.hpp"
 #include "Exceptions.hpp"
+#include "SharedTileCache.hpp"
 
 
 namespace GeoStar {
@@ -31,7 +41,13 @@ namespace GeoStar {
     public:
         Slice slice;
         int sliceWidth;
-        std::vector<T> data;
+        // the pixels; the buffer may be shared with the SharedTileCache (and other TileIOs), so
+        //  it is read-only once filled.  data points into it.
+        std::shared_ptr<std::vector<T> > buffer;
+        const T *data;
+        int tileNumber;
+        int pins;           // > 0 while a caller holds a reference; pinned tiles are not evicted
+
         Tile(Slice &slice) {
             this->slice = slice;
             sliceWidth = slice.getDeltaX();
@@ -40,26 +56,133 @@ namespace GeoStar {
                 if (sliceWidth < 0) std::cerr << " deltaX < 0 ";
                 else std::cerr << " deltaY < 0 ";
             }
-            data.resize(sliceWidth * slice.getDeltaY());
+            buffer = std::make_shared<std::vector<T> >(sliceWidth * slice.getDeltaY());
+            data = buffer->data();
+            tileNumber = -1;
+            pins = 0;
+        }
+
+        // a tile whose pixels are in buffer
+        Tile(Slice &slice, const std::shared_ptr<std::vector<T> > &buffer) {
+            this->slice = slice;
+            sliceWidth = slice.getDeltaX();
+            this->buffer = buffer;
+            data = buffer->data();
+            tileNumber = -1;
+            pins = 0;
         }
         
         Tile() {
             sliceWidth = 0;
+            data = NULL;
+            tileNumber = -1;
+            pins = 0;
         }
         
     };
 
+
+    // A Tile reference that keeps the tile in its TileIO's cache while it is held.
+    template <class T>
+    class PinnedTile {
+    private:
+        Tile<T> *tile;
+    public:
+        explicit PinnedTile(Tile<T> &tile) : tile(&tile) {
+            this->tile->pins++;
+        }
+        PinnedTile(const PinnedTile &other) : tile(other.tile) {
+            tile->pins++;
+        }
+        PinnedTile &operator=(const PinnedTile &other) {
+            other.tile->pins++;
+            tile->pins--;
+            tile = other.tile;
+            return *this;
+        }
+        ~PinnedTile() {
+            tile->pins--;
+        }
+        inline Tile<T> &operator*() const {
+            return *tile;
+        }
+        inline Tile<T> *operator->() const {
+            return tile;
+        }
+    };
+
   template <class T>
   class TileIO {
 
   private:
       const Raster *raster;
-      std::map<int, Tile<T> > tiles;
       int maxNumberTiles;
       Slice tileDescriptor;
-      // Key is the tilenumber, and value is the last time accessed (timer)
-      std::map<int, long int> lastAccessTimes;
-      long int timer;
+
+      // The cache: the tiles in least-recently-used order (most recent first), and an index from
+      //  tile number to list position.  List nodes never move, so Tile references stay valid until
+      //  the tile is evicted; lookup, use and eviction are all O(1).
+      std::list<Tile<T> > tiles;
+      std::unordered_map<int, typename std::list<Tile<T> >::iterator> tileIndex;
+      // the data buffers of evicted tiles (that nobody else shares), re-used for the next tiles read
+      std::vector<std::shared_ptr<std::vector<T> > > bufferPool;
+      // the tile of the last at/neighborhood lookup (NULL after an eviction): consecutive pixels
+      //  are nearly always in the same tile, and then need no lookup at all
+      Tile<T> *lastTile;
+
+      // is (x, y) .. (x+w-1, y+h-1) inside lastTile?
+      inline bool inLastTile(const long int &x, const long int &y, const long int &w, const long int &h) const {
+          return lastTile != NULL
+              && x >= lastTile->slice.getX0() && x + w <= lastTile->slice.getX0() + lastTile->sliceWidth
+              && y >= lastTile->slice.getY0() && y + h <= lastTile->slice.getY0() + lastTile->slice.getDeltaY();
+      }
+
+      // makes the tile holding (x, y) lastTile
+      void findTile(const long int &x, const long int &y);
+
+      // the window of a tile (smaller at the right and bottom edges)
+      Slice tileSliceFor(const int &tileNumber) const;
+
+      // the key in the SharedTileCache of a tile of raster
+      static SharedTileCache::Key keyFor(const Raster *raster, const Slice &tileSlice);
+
+      // Prefetching: the direction the reads move in, in tiles (-1, 0 or 1 each), learned from
+      //  the misses; (0,0) when unknown.  Tiles ahead of a miss
+      //  are read by a background thread if the HDF5 library is thread-safe; otherwise a miss
+      //  reads the tiles ahead in the same HDF5 read, when the direction is along a row or column.
+      int prefetchDepth;
+      int dirX, dirY;
+      int lastMissX, lastMissY;
+      int lastStepX, lastStepY;
+      bool threaded;
+
+      std::thread worker;
+      std::mutex prefetchMutex;
+      std::condition_variable prefetchWake;      // work for the worker, or stopping
+      std::condition_variable prefetchDone;      // a tile was read by the worker
+      std::deque<int> prefetchQueue;
+      std::unordered_set<int> prefetchPending;   // queued, or being read
+      std::unordered_map<int, std::shared_ptr<std::vector<T> > > prefetched;
+      bool stopping;
+
+      // learns the direction from a miss at tile (tileX, tileY)
+      void noteMiss(const int &tileX, const int &tileY);
+      // queues the tiles ahead of (tileX, tileY) for the worker
+      void schedulePrefetch(const int &tileX, const int &tileY);
+      // the worker thread
+      void prefetchLoop();
+      // takes the tile from the worker's results (waiting if it is being read); empty if not there
+      std::shared_ptr<std::vector<T> > takePrefetched(const int &tileNumber);
+      // without a worker: reads the tile and the tiles ahead of it in one read, into the cache
+      bool readAhead(const int &tileNumber);
+      // adds a read tile to the front of the cache
+      void addTile(const int &tileNumber, const Slice &tileSlice, const std::shared_ptr<std::vector<T> > &buffer);
+
+      // sets up the tiling and the (empty) cache; used by the constructors
+      void init(const Slice &tileDescriptor, const int &maxNumberTiles);
+
+      TileIO(const TileIO &) = delete;
+      TileIO &operator=(const TileIO &) = delete;
       
       int rasterWidth;
       int rasterHeight;
@@ -71,14 +194,46 @@ namespace GeoStar {
       double xScale;
       double yScale;
       
-      Tile<T> verifyNeededTileIsAvailable(const int &tileNeeded);
+      // the tile, read in if needed, and marked most recently used
+      Tile<T> &verifyNeededTileIsAvailable(const int &tileNeeded);
       void readInNeededTile(int tileNumber);
-      void throwOutLeastUsedTile();
+      // evicts the least recently used tile that is not pinned; false if all are pinned
+      bool throwOutLeastUsedTile();
 
   public:
       // create a TileIO with strideX and strideY (defaulted to 1), to be able to skip over pixels,
       //  i.e. skip every strideX pixels (in x-direction), etc.
       TileIO(Raster *raster, const Slice &tileDescriptor, const int &maxNumberTiles = 1);
+
+      // memory for the tiles of a TileIO, by default
+      static const size_t DEFAULT_MEMORY_BUDGET = 67108864;   // 64 MiB
+
+      // create a TileIO that picks its own tiles: the raster's chunks (so a tile read never
+      //  decompresses a chunk only partly used), or 256 X 256 for contiguous rasters, and as many
+      //  of them as a footprint of footprintX X footprintY pixels needs, within memoryBudget bytes.
+      //  The footprint is the input window that one step of the caller touches, e.g. for a rotation,
+      //  the input span of one output row: (|cos|*width + 2) X (|sin|*width + 2).
+      TileIO(Raster *raster, const long int &footprintX, const long int &footprintY,
+             const size_t &memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+      // stops the prefetch thread, if any
+      ~TileIO();
+
+      // the tile size the footprint constructor picks for raster: its chunks (256 X 256 if it is
+      //  contiguous), several of them if they are tiny, or parts of one if it is large
+      static void tileSize(const Raster *raster, long int &cx, long int &cy,
+                           const size_t &memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+      // reads the window of raster into out (row by row) through the SharedTileCache, in the tiles
+      //  tileSize picks, so the tiles read by one operation serve the next (and the TileIOs of
+      //  the same raster).  Holds io around each HDF5 read only; tiles found in the cache are
+      //  copied without it.  With the cache off (budget 0), reads just the window.
+      static void readWindow(const Raster *raster, const Slice &window, T *out, std::mutex &io);
+
+      // how many tiles ahead are read (default 2; 0 turns prefetching off)
+      inline void setPrefetchDepth(const int &depth) {
+          prefetchDepth = std::max(0, depth);
+      }
       
       // return maxNumberTiles
       inline long int getMaxNumberTiles() {
@@ -92,6 +247,22 @@ namespace GeoStar {
       
       std::vector<T> tileRead(const Slice &pixelsToRead);
 
+      // the pixel at (x, y), straight from the cached tile; no allocation.
+      //  Throws SliceDataError outside the raster.
+      inline T at(const long int &x, const long int &y) {
+          if (!inLastTile(x, y, 1, 1)) findTile(x, y);
+          return lastTile->data[(y - lastTile->slice.getY0()) * lastTile->sliceWidth + (x - lastTile->slice.getX0())];
+      }
+
+      // copies the w X h pixels at (x, y) to out (row by row, w*h elements); no allocation.
+      //  A neighborhood inside one tile (the usual case for 2x2 interpolation) is a few loads.
+      //  Throws SliceDataError if any of it is outside the raster.
+      void neighborhood(const long int &x, const long int &y, const long int &w, const long int &h, T *out);
+
+      // the tile holding pixel (x, y), read in if needed, pinned in the cache while the
+      //  PinnedTile exists (so it can be used while other tiles are read).
+      PinnedTile<T> tileAt(const long int &x, const long int &y);
+
   }; // end class: TileIO
   
 }// end namespace GeoStar
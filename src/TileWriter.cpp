@@ -0,0 +1,174 @@
+// TileWriter.cpp
+//
+//--------------------------------------------
+
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+
+#include "geostar.hpp"
+#include "Slice.hpp"
+#include "TileWriter.hpp"
+
+namespace GeoStar {
+
+    template <class T>
+    const size_t TileWriter<T>::DEFAULT_MEMORY_BUDGET;
+
+
+
+    template <class T>
+    TileWriter<T>::TileWriter(Raster *raster, const size_t &memoryBudget) {
+        this->raster = raster;
+        rasterWidth = raster->get_nx();
+        rasterHeight = raster->get_ny();
+
+        // tiles are whole chunks, so a written tile replaces its chunk without merging:
+        if (!raster->getChunkSize(tileWidth, tileHeight)) {
+            tileWidth = 256;
+            tileHeight = 256;
+        }
+        tileWidth = std::max(1L, std::min(tileWidth, rasterWidth));
+        tileHeight = std::max(1L, std::min(tileHeight, rasterHeight));
+        numberXTiles = (rasterWidth + tileWidth - 1) / tileWidth;
+        numberYTiles = (rasterHeight + tileHeight - 1) / tileHeight;
+
+        // a tile costs its pixels and one byte of mask per pixel:
+        size_t tileBytes = (size_t)(tileWidth * tileHeight) * (sizeof(T) + 1);
+        maxNumberTiles = (int)std::max((size_t)1, memoryBudget / tileBytes);
+        tileIndex.reserve(2 * maxNumberTiles);
+        lastTile = NULL;
+    }// end-TileWriter-constructor
+
+
+
+    template <class T>
+    TileWriter<T>::~TileWriter() {
+        // destructors must not throw; a failed final write is lost, as with any unclosed file:
+        try {
+            flush();
+        } catch (...) {
+        }
+    }// end-TileWriter-destructor
+
+
+
+    template <class T>
+    void TileWriter<T>::findTile(const long int &x, const long int &y) {
+        if (x < 0 || x >= rasterWidth) throw_SliceDataError("x outside raster in TileWriter");
+        if (y < 0 || y >= rasterHeight) throw_SliceDataError("y outside raster in TileWriter");
+
+        int tileX = x / tileWidth;
+        int tileY = y / tileHeight;
+        int tileNumber = tileY * numberXTiles + tileX;
+
+        typename std::unordered_map<int, typename std::list<DirtyTile<T> >::iterator>::iterator found
+            = tileIndex.find(tileNumber);
+        if (found != tileIndex.end()) {
+            // most recently used goes to the front:
+            if (found->second != tiles.begin()) tiles.splice(tiles.begin(), tiles, found->second);
+            lastTile = &tiles.front();
+            return;
+        }
+
+        // make room, writing out the least recently used tile:
+        if ((int)tiles.size() >= maxNumberTiles) {
+            typename std::list<DirtyTile<T> >::iterator last = tiles.end();
+            --last;
+            writeTile(*last);
+            tileIndex.erase(last->tileNumber);
+            tiles.erase(last);
+        }
+
+        long int x0 = tileX * tileWidth;
+        long int y0 = tileY * tileHeight;
+        Slice tileSlice(x0, y0, std::min(tileWidth, rasterWidth - x0), std::min(tileHeight, rasterHeight - y0));
+        tiles.push_front(DirtyTile<T>(tileSlice, tileNumber));
+        tileIndex[tileNumber] = tiles.begin();
+        lastTile = &tiles.front();
+    }// end: findTile
+
+
+
+    template <class T>
+    void TileWriter<T>::load(DirtyTile<T> &tile) {
+        if (tile.loaded) return;
+        if (tile.nWritten < (long int)tile.data.size()) {
+            std::vector<T> old(tile.data.size());
+            raster->read(tile.slice, old);
+            for (size_t k = 0; k < old.size(); k++)
+                if (!tile.written[k]) tile.data[k] = old[k];
+        }
+        tile.loaded = true;
+    }// end: load
+
+
+
+    template <class T>
+    void TileWriter<T>::writeTile(DirtyTile<T> &tile) {
+        if (tile.nWritten == 0) return;
+        load(tile);
+        raster->write(tile.slice, tile.data);
+    }// end: writeTile
+
+
+
+    template <class T>
+    void TileWriter<T>::fill(const Slice &slice, const T &value) {
+        long int x0 = std::max(0L, slice.getX0());
+        long int y0 = std::max(0L, slice.getY0());
+        long int x1 = std::min(rasterWidth, slice.getX0() + slice.getDeltaX());
+        long int y1 = std::min(rasterHeight, slice.getY0() + slice.getDeltaY());
+
+        // a tile at a time, a row of it at a time:
+        for (long int ty = y0; ty < y1; ty = (ty / tileHeight + 1) * tileHeight) {
+            for (long int tx = x0; tx < x1; tx = (tx / tileWidth + 1) * tileWidth) {
+                findTile(tx, ty);
+                DirtyTile<T> &tile = *lastTile;
+                long int xEnd = std::min(x1, tile.slice.getX0() + tile.sliceWidth);
+                long int yEnd = std::min(y1, tile.slice.getY0() + tile.slice.getDeltaY());
+                for (long int y = ty; y < yEnd; y++) {
+                    long int offset = offsetIn(tile, tx, y);
+                    for (long int x = tx; x < xEnd; x++, offset++) tile.set(offset, value);
+                }// endfor: y
+            }// endfor: tx
+        }// endfor: ty
+    }// end: fill
+
+
+
+    template <class T>
+    void TileWriter<T>::flush() {
+        // in file order, so the writes go to the chunks in the order they are stored:
+        std::vector<DirtyTile<T> *> order;
+        order.reserve(tiles.size());
+        for (typename std::list<DirtyTile<T> >::iterator it = tiles.begin(); it != tiles.end(); ++it)
+            order.push_back(&*it);
+        std::sort(order.begin(), order.end(), [](const DirtyTile<T> *a, const DirtyTile<T> *b) {
+            return a->tileNumber < b->tileNumber;
+        });
+        for (size_t k = 0; k < order.size(); k++) writeTile(*order[k]);
+
+        tiles.clear();
+        tileIndex.clear();
+        lastTile = NULL;
+    }// end: flush
+
+
+
+    // explicit instantiations
+    template class TileWriter<uint8_t>;
+    template class TileWriter<int8_t>;
+    template class TileWriter<uint16_t>;
+    template class TileWriter<int16_t>;
+    template class TileWriter<uint32_t>;
+    template class TileWriter<int32_t>;
+    template class TileWriter<uint64_t>;
+    template class TileWriter<int64_t>;
+    template class TileWriter<float>;
+    template class TileWriter<double>;
+
+}// end namespace GeoStar
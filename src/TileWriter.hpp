@@ -0,0 +1,154 @@
+// TileWriter.hpp
+//
+//----------------------------------------
+#ifndef TILEWRITER_HPP_
+#define TILEWRITER_HPP_
+
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "Slice.hpp"
+#include "Exceptions.hpp"
+
+
+namespace GeoStar {
+    class Raster;
+
+    // a tile being written: its pixels, and which of them have been set (the others still hold
+    //  whatever is in the raster, and are read only if needed)
+    template <class T>
+    class DirtyTile {
+    public:
+        Slice slice;
+        int sliceWidth;
+        int tileNumber;
+        std::vector<T> data;
+        std::vector<uint8_t> written;   // 1 where data holds a new pixel
+        long int nWritten;
+        bool loaded;                    // data holds every pixel (new or read from the raster)
+
+        DirtyTile(const Slice &slice, const int &tileNumber) {
+            this->slice = slice;
+            this->tileNumber = tileNumber;
+            sliceWidth = slice.getDeltaX();
+            data.resize(sliceWidth * slice.getDeltaY());
+            written.resize(data.size(), 0);
+            nWritten = 0;
+            loaded = false;
+        }
+
+        inline void set(const long int &offset, const T &value) {
+            data[offset] = value;
+            if (!written[offset]) {
+                written[offset] = 1;
+                nWritten++;
+            }
+        }
+    };
+
+
+/** \brief TileWriter -- a write-back buffer for code that writes scattered pixels.
+
+Each Raster::write of a few pixels is a read-modify-write of every HDF5 chunk it touches.  A
+TileWriter collects the pixels instead, in tiles the size of the raster's chunks, and writes a tile
+only when it has to make room for another one, or at flush (or when the TileWriter goes away).  So
+thousands of small writes become one write per chunk touched.
+
+\see TileIO, Raster
+
+\par Usage Overview
+\code
+   GeoStar::TileWriter<uint8_t> writer(ras);
+   for (...) writer.set(x, y, 255);
+   writer.flush();      // or let writer go out of scope
+\endcode
+
+\par Details
+A tile whose pixels have all been set is written as is; for any other tile, the pixels that were
+not set are read from the raster first (one read of the tile), so they are left unchanged.  get
+returns the pixel as it will be, reading the tile if it has to.
+
+Reads of the raster by other means (Raster::read, TileIO) do not see the pixels until they are
+flushed.
+*/
+  template <class T>
+  class TileWriter {
+
+  private:
+      Raster *raster;
+      long int rasterWidth, rasterHeight;
+      long int tileWidth, tileHeight;
+      long int numberXTiles, numberYTiles;
+      int maxNumberTiles;
+
+      // the tiles, most recently used first, and an index from tile number to list position
+      std::list<DirtyTile<T> > tiles;
+      std::unordered_map<int, typename std::list<DirtyTile<T> >::iterator> tileIndex;
+      // the tile of the last set/get: consecutive pixels are nearly always in the same tile
+      DirtyTile<T> *lastTile;
+
+      inline bool inLastTile(const long int &x, const long int &y) const {
+          return lastTile != NULL
+              && x >= lastTile->slice.getX0() && x < lastTile->slice.getX0() + lastTile->sliceWidth
+              && y >= lastTile->slice.getY0() && y < lastTile->slice.getY0() + lastTile->slice.getDeltaY();
+      }
+
+      inline long int offsetIn(const DirtyTile<T> &tile, const long int &x, const long int &y) const {
+          return (y - tile.slice.getY0()) * tile.sliceWidth + (x - tile.slice.getX0());
+      }
+
+      // makes the tile holding (x, y) lastTile, starting it (and writing out the least recently
+      //  used tile, if the buffer is full) if needed
+      void findTile(const long int &x, const long int &y);
+
+      // reads the pixels of the tile that have not been set
+      void load(DirtyTile<T> &tile);
+
+      // writes the tile to the raster
+      void writeTile(DirtyTile<T> &tile);
+
+      TileWriter(const TileWriter &) = delete;
+      TileWriter &operator=(const TileWriter &) = delete;
+
+  public:
+      // memory for the tiles of a TileWriter, by default
+      static const size_t DEFAULT_MEMORY_BUDGET = 67108864;   // 64 MiB
+
+      // create a TileWriter with tiles the size of the raster's chunks (256 X 256 for contiguous
+      //  rasters), as many as memoryBudget bytes hold
+      TileWriter(Raster *raster, const size_t &memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+      // flushes; a failed write is lost (call flush first to get its exception)
+      ~TileWriter();
+
+      // set the pixel at (x, y).  Throws SliceDataError outside the raster.
+      inline void set(const long int &x, const long int &y, const T &value) {
+          if (!inLastTile(x, y)) findTile(x, y);
+          lastTile->set(offsetIn(*lastTile, x, y), value);
+      }
+
+      // the pixel at (x, y), as it will be written.  Throws SliceDataError outside the raster.
+      inline T get(const long int &x, const long int &y) {
+          if (!inLastTile(x, y)) findTile(x, y);
+          long int offset = offsetIn(*lastTile, x, y);
+          if (!lastTile->loaded && !lastTile->written[offset]) load(*lastTile);
+          return lastTile->data[offset];
+      }
+
+      // set every pixel of slice (clipped to the raster) to value
+      void fill(const Slice &slice, const T &value);
+
+      // writes all tiles to the raster, and empties the buffer
+      void flush();
+
+  }; // end class: TileWriter
+
+}// end namespace GeoStar
+
+
+#endif //TILEWRITER_HPP_
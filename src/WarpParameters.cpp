@@ -144,6 +144,47 @@ namespace GeoStar {
         //return GeoStar::Point(rbx.dot(x), rby.dot(x));
     }// end: GCPTransform
 
+
+
+    const int WarpParameters::xPower[21] = {0, 1, 0, 1, 2, 0, 2, 1, 3, 0, 2, 3, 1, 4, 0, 3, 2, 4, 1, 5, 0};
+    const int WarpParameters::yPower[21] = {0, 0, 1, 1, 0, 2, 1, 2, 0, 3, 2, 1, 3, 0, 4, 2, 3, 1, 4, 0, 5};
+
+
+
+    void WarpParameters::rowPolynomial(const Eigen::VectorXd &b, const int &nterms, const double &riy,
+                                       double a[6]) const {
+        double ypow[6];
+        ypow[0] = 1.0;
+        for (int k = 1; k < 6; k++) ypow[k] = ypow[k-1] * riy;
+        for (int k = 0; k < 6; k++) a[k] = 0.0;
+        for (int t = 0; t < nterms; t++) a[xPower[t]] += b(t) * ypow[yPower[t]];
+    }// end: rowPolynomial
+
+
+
+    void WarpParameters::GCPTransformRow(const double &riy, const double &rix0, const long int &n,
+                                         double *outX, double *outY) const {
+        if (pbx != 3 && pbx != 6 && pbx != 10 && pbx != 15 && pbx != 21) {
+            // screwed up ... same as GCPTransform
+            for (long int k = 0; k < n; k++) {
+                outX[k] = -999.0;
+                outY[k] = -999.0;
+            }
+            return;
+        }
+
+        double ax[6], ay[6];
+        rowPolynomial(rbx, pbx, riy, ax);
+        rowPolynomial(rby, pbx, riy, ay);
+
+        // Horner form, the same number of steps for every pixel (the unused high terms are 0):
+        for (long int k = 0; k < n; k++) {
+            double x = rix0 + k;
+            outX[k] = ((((ax[5]*x + ax[4])*x + ax[3])*x + ax[2])*x + ax[1])*x + ax[0];
+            outY[k] = ((((ay[5]*x + ay[4])*x + ay[3])*x + ay[2])*x + ay[1])*x + ay[0];
+        }// endfor: k
+    }// end: GCPTransformRow
+
     
     // calculate the error associated with the regression model of the set of 2D GCP
     //  (Ground Control Point) pairs.
@@ -83,6 +83,15 @@ namespace GeoStar {
                           const std::vector<double> rox, const std::vector<double> roy,
                           int *order);
 
+        // the powers of x and y in each of the (up to) 21 terms of the polynomials, in the order of
+        //  the coefficients
+        static const int xPower[21];
+        static const int yPower[21];
+
+        // the coefficients of the polynomial in x that the transform becomes along row riy:
+        //  f(x) = a[0] + a[1]*x + ... + a[5]*x^5
+        void rowPolynomial(const Eigen::VectorXd &b, const int &nterms, const double &riy, double a[6]) const;
+
     public:
 
         // create a WarpParameters
@@ -273,6 +282,34 @@ namespace GeoStar {
                            const double *roxerr, const double *royerr);
 
 
+
+        /** \brief WarpParameters::GCPTransformRow computes the transform for n consecutive pixels of a row.
+
+         The same as calling GCPTransform(rix0 + k, riy) for k = 0 .. n-1, but much faster: along a row, y
+         is fixed, so the polynomial is first reduced to one in x alone (of degree 1 to 5), which is then
+         evaluated in Horner form for each pixel.  The loop over the pixels has no branches and no
+         dependencies between pixels, so the compiler vectorizes it.
+
+         \see  GCPTransform
+
+         \param[in] riy
+         The y-coordinate of the row.
+         \param[in] rix0
+         The x-coordinate of the first pixel.
+         \param[in] n
+         The number of pixels.
+         \param[out] outX
+         n transformed x-coordinates.
+         \param[out] outY
+         n transformed y-coordinates.
+
+         \par Exceptions
+         none; like GCPTransform, the coordinates are all -999.0 if there is no valid solution.
+         */
+        void GCPTransformRow(const double &riy, const double &rix0, const long int &n,
+                             double *outX, double *outY) const;
+
+
         /** \brief WarpParameters::GCPRootMeanSq calculates the error associated with the regression model
            of the set of 2D GCP (Ground Control Point) pairs.
          
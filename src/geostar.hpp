@@ -10,6 +10,9 @@
 #include "Image.hpp"
 #include "Raster.hpp"
 #include "Slice.hpp"
+#include "RasterLayout.hpp"
+#include "ChunkCache.hpp"
+#include "SharedTileCache.hpp"
 #include "RasterFunction.hpp"
 #include "Vector.hpp"
 #include "Shape.hpp"